@@ -70,6 +70,12 @@ void BaseConnectionManager::initialize(int stage)
 
         EV_TRACE << "initializing BaseConnectionManager\n";
 
+        // NICs of all hosts register with this module and are called directly (as is the TraCIScenarioManager), which cannot be split across partitions
+        static cConfigOption* parallelSimulation = cConfigOption::find("parallel-simulation");
+        if (parallelSimulation && getEnvir()->getConfig()->getAsBool(parallelSimulation, false)) {
+            throw cRuntimeError("Parallel simulation (parallel-simulation = true) is not supported by Veins: radio frames and vehicle updates are delivered by direct method calls and sendDirect(), which cannot cross partitions. To use multiple cores, run independent replications in parallel instead (e.g., via opp_runall)");
+        }
+
         BaseWorldUtility* world = FindModule<BaseWorldUtility*>::findGlobalModule();
 
         ASSERT(world != nullptr);
@@ -82,6 +88,14 @@ void BaseConnectionManager::initialize(int stage)
         else
             sendDirect = false;
 
+        int receptionWorkerThreads = hasPar("receptionWorkerThreads") ? par("receptionWorkerThreads").intValue() : 0;
+        if (receptionWorkerThreads < 0) {
+            throw cRuntimeError("receptionWorkerThreads was %d, but must not be negative", receptionWorkerThreads);
+        }
+        if (receptionWorkerThreads > 0) {
+            workerPool = make_unique<WorkerPool>(receptionWorkerThreads);
+        }
+
         maxInterferenceDistance = calcInterfDist();
         maxDistSquared = maxInterferenceDistance * maxInterferenceDistance;
 
@@ -24,11 +24,14 @@
 
 #pragma once
 
+#include <memory>
+
 #include "veins/veins.h"
 
 #include "veins/base/utils/AntennaPosition.h"
 #include "veins/base/connectionManager/NicEntry.h"
 #include "veins/base/utils/Heading.h"
+#include "veins/base/utils/WorkerPool.h"
 
 namespace veins {
 
@@ -253,6 +256,9 @@ protected:
     /** @brief Does the ConnectionManager use sendDirect or not?*/
     bool sendDirect;
 
+    /** @brief Worker threads for evaluating receptions in parallel (nullptr if disabled) */
+    std::unique_ptr<WorkerPool> workerPool;
+
     /** @brief Stores the size of the playground.*/
     const Coord* playgroundSize;
 
@@ -426,6 +432,12 @@ public:
     /** @brief Returns the ingates of all nics in range*/
     const NicEntry::GateList& getGateList(int nicID) const;
 
+    /** @brief Returns the worker threads physical layers may use to evaluate receptions in parallel, or nullptr if disabled */
+    WorkerPool* getWorkerPool() const
+    {
+        return workerPool.get();
+    }
+
     /** @brief Returns the ingate of the with id==targetID, or 0 if not in range*/
     const cGate* getOutGateTo(const NicEntry* nic, const NicEntry* targetNic) const;
 };
@@ -86,17 +86,29 @@ void ChannelAccess::sendToChannel(cPacket* msg)
 
     const auto& gateList = cc->getGateList(getParentModule()->getId());
 
+    std::vector<ChannelCopy> copies;
     for (auto&& entry : gateList) {
         const auto gate = entry.second;
         const auto propagationDelay = calculatePropagationDelay(entry.first);
 
         if (useSendDirect) {
             for (int gateIndex = gate->getBaseId(); gateIndex < gate->getBaseId() + gate->size(); gateIndex++) {
-                sendDirect(msg->dup(), propagationDelay, msg->getDuration(), gate->getOwnerModule(), gateIndex);
+                copies.push_back({msg->dup(), entry.first->chAccess, propagationDelay, gate, gateIndex});
             }
         }
         else {
-            sendDelayed(msg->dup(), propagationDelay, gate);
+            copies.push_back({msg->dup(), entry.first->chAccess, propagationDelay, gate, -1});
+        }
+    }
+
+    prepareChannelCopies(copies);
+
+    for (auto&& copy : copies) {
+        if (useSendDirect) {
+            sendDirect(copy.msg, copy.propagationDelay, msg->getDuration(), copy.gate->getOwnerModule(), copy.gateIndex);
+        }
+        else {
+            sendDelayed(copy.msg, copy.propagationDelay, copy.gate);
         }
     }
     // Original message no longer needed, copies have been sent to all possible receivers.
@@ -96,6 +96,24 @@ protected:
      */
     simtime_t calculatePropagationDelay(const NicEntry* nic);
 
+    /** @brief A copy of a message that sendToChannel() is about to send to one receiver. */
+    struct ChannelCopy {
+        cPacket* msg;
+        ChannelAccess* receiver;
+        simtime_t propagationDelay;
+        cGate* gate;
+        int gateIndex; /**< index of the gate to sendDirect() to (if useSendDirect is set) */
+    };
+
+    /**
+     * @brief Called by sendToChannel() with all copies of a message before any of them is sent.
+     *
+     * Does nothing by default.
+     */
+    virtual void prepareChannelCopies(const std::vector<ChannelCopy>& copies)
+    {
+    }
+
     /** @brief Sends a message to all nics connected to this one.
      *
      * This function has to be called whenever a packet is supposed to be
@@ -292,7 +292,7 @@ void BaseMobility::updatePosition()
     // publish the the new move
     emit(mobilityStateChangedSignal, this);
 
-    if (hasGUI()) {
+    if (!headless && hasGUI()) {
         std::ostringstream osDisplayTag;
 #ifdef __APPLE__
         const int iPrecis = 0;
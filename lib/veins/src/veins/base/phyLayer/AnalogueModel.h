@@ -77,6 +77,37 @@ public:
     {
         return false;
     }
+
+    /**
+     * If filterSignalAt() may be called from worker threads (concurrently for different signals), returns true here.
+     *
+     * This allows computing the attenuation of a frame for many receivers in parallel, see BasePhyLayer.
+     */
+    virtual bool canFilterConcurrently() const
+    {
+        return false;
+    }
+
+    /**
+     * Called on the main thread before a batch of concurrent calls to filterSignalAt().
+     *
+     * Models can bring lazily initialized state up to date here.
+     */
+    virtual void prepareConcurrentFiltering()
+    {
+    }
+
+    /**
+     * Same as filterSignal(), but evaluates sender and receiver positions at time now (instead of the current simulation time).
+     *
+     * Only called if canFilterConcurrently() returns true, and then potentially from worker threads.
+     * Implementations must produce the same result as filterSignal() would at time now,
+     * must not modify shared state, and must not use simulation services (RNGs, signals, statistics, ...).
+     */
+    virtual void filterSignalAt(Signal* signal, simtime_t now)
+    {
+        throw cRuntimeError("This analogue model cannot filter signals concurrently");
+    }
 };
 
 using AnalogueModelList = std::vector<std::unique_ptr<AnalogueModel>>;
@@ -62,6 +62,16 @@ public:
      */
     virtual double getGain(Coord ownPos, Coord ownOrient, Coord otherPos);
 
+    /**
+     * Returns true if getGain() may be called from multiple threads at once.
+     *
+     * Subclasses whose getGain() modifies any state have to return false.
+     */
+    virtual bool canComputeGainConcurrently() const
+    {
+        return true;
+    }
+
     virtual double getLastAngle()
     {
         return -1.0;
@@ -35,6 +35,7 @@
 #include "veins/base/phyLayer/Decider.h"
 #include "veins/base/modules/BaseWorldUtility.h"
 #include "veins/base/connectionManager/BaseConnectionManager.h"
+#include "veins/modules/utility/Profiler.h"
 
 using namespace veins;
 
@@ -375,6 +376,7 @@ void BasePhyLayer::initializeAnalogueModels(cXMLElement* xmlConfig)
 
 void BasePhyLayer::handleMessage(cMessage* msg)
 {
+    VEINS_PROFILE_SCOPE_KIND("BasePhyLayer::handleMessage", msg->getKind());
 
     // self messages
     if (msg->isSelfMessage()) {
@@ -645,23 +647,34 @@ void BasePhyLayer::filterSignal(AirFrame* frame)
 {
     ASSERT(dynamic_cast<ChannelAccess* const>(frame->getArrivalModule()) == this);
     ASSERT(dynamic_cast<ChannelAccess* const>(frame->getSenderModule()));
-    Signal& signal = frame->getSignal();
 
+    // use signal filtered by the sender, if it was filtered for this very antenna position and heading
+    auto precomputed = precomputedSignals.find(frame);
+    if (precomputed != precomputedSignals.end()) {
+        const PrecomputedSignal& p = precomputed->second;
+        bool valid = (p.receptionTime == simTime()) && p.receiverPosition.isIdenticalTo(antennaPosition) && (p.receiverHeading.getRad() == antennaHeading.getRad());
+        if (valid) frame->getSignal() = p.signal;
+        precomputedSignals.erase(precomputed);
+        if (valid) return;
+    }
+
+    applyAnalogueModels(frame->getSignal(), frame->getPoa(), antennaPosition, antennaHeading, simTime(), false);
+}
+
+void BasePhyLayer::applyAnalogueModels(Signal& signal, const POA& senderPOA, const AntennaPosition& receiverPosition, const Heading& receiverHeading, simtime_t now, bool concurrently)
+{
     // Extract position and orientation of sender and receiver (this module) first
-    const AntennaPosition receiverPosition = antennaPosition;
-    const Coord receiverOrientation = antennaHeading.toCoord();
-    // get POA from frame with the sender's position, orientation and antenna
-    POA& senderPOA = frame->getPoa();
-    const AntennaPosition senderPosition = senderPOA.pos;
-    const Coord senderOrientation = senderPOA.orientation;
+    const Coord receiverOrientation = receiverHeading.toCoord();
+    const AntennaPosition& senderPosition = senderPOA.pos;
+    const Coord& senderOrientation = senderPOA.orientation;
 
     // add position information to signal
     signal.setSenderPoa(senderPOA);
     signal.setReceiverPoa({receiverPosition, receiverOrientation, antenna});
 
     // compute gains at sender and receiver antenna
-    double receiverGain = antenna->getGain(receiverPosition.getPositionAt(), receiverOrientation, senderPosition.getPositionAt());
-    double senderGain = senderPOA.antenna->getGain(senderPosition.getPositionAt(), senderOrientation, receiverPosition.getPositionAt());
+    double receiverGain = antenna->getGain(receiverPosition.getPositionAt(now), receiverOrientation, senderPosition.getPositionAt(now));
+    double senderGain = senderPOA.antenna->getGain(senderPosition.getPositionAt(now), senderOrientation, receiverPosition.getPositionAt(now));
 
     // add the resulting total gain to the attenuations list
     EV_TRACE << "Sender's antenna gain: " << senderGain << endl;
@@ -674,10 +687,68 @@ void BasePhyLayer::filterSignal(AirFrame* frame)
 
     // apply all analouge models that are *not* suitable for thresholding now
     for (auto& analogueModel : analogueModels) {
-        analogueModel->filterSignal(&signal);
+        if (concurrently) {
+            analogueModel->filterSignalAt(&signal, now);
+        }
+        else {
+            analogueModel->filterSignal(&signal);
+        }
     }
 }
 
+bool BasePhyLayer::canFilterSignalConcurrently(const Antenna& senderAntenna) const
+{
+    if (!antenna->canComputeGainConcurrently() || !senderAntenna.canComputeGainConcurrently()) return false;
+    for (auto& analogueModel : analogueModels) {
+        if (!analogueModel->canFilterConcurrently()) return false;
+    }
+    return true;
+}
+
+void BasePhyLayer::prepareChannelCopies(const std::vector<ChannelCopy>& copies)
+{
+    WorkerPool* workerPool = cc->getWorkerPool();
+    if (!workerPool || copies.size() < 2) return;
+#if !defined(VEINS_MIN_LOG_LEVEL) || VEINS_MIN_LOG_LEVEL <= VEINS_LOG_LEVEL_TRACE
+    // analogue models log while filtering, which must not happen on worker threads
+    if (getEnvir()->isLoggingEnabled()) return;
+#endif
+
+    struct Job {
+        AirFrame* frame;
+        BasePhyLayer* receiver;
+        PrecomputedSignal* result;
+    };
+    std::vector<Job> jobs;
+    jobs.reserve(copies.size());
+
+    // create all results on this thread, so that worker threads only fill in existing entries
+    for (auto&& copy : copies) {
+        auto frame = dynamic_cast<AirFrame*>(copy.msg);
+        auto receiver = dynamic_cast<BasePhyLayer*>(copy.receiver);
+        if (!frame || !receiver || !receiver->canFilterSignalConcurrently(*frame->getPoa().antenna)) continue;
+        for (auto& analogueModel : receiver->analogueModels) {
+            analogueModel->prepareConcurrentFiltering();
+        }
+        PrecomputedSignal& result = receiver->precomputedSignals[frame];
+        result.receiverPosition = receiver->antennaPosition;
+        result.receiverHeading = receiver->antennaHeading;
+        result.receptionTime = simTime() + copy.propagationDelay;
+        jobs.push_back({frame, receiver, &result});
+    }
+
+    // same steps as handleAirFrameStartReceive() and filterSignal() will take when the frame arrives
+    workerPool->parallelFor(jobs.size(), [&jobs](size_t i) {
+        const Job& job = jobs[i];
+        Signal& signal = job.result->signal;
+        signal = job.frame->getSignal();
+        if (job.receiver->usePropagationDelay) {
+            signal.setPropagationDelay(job.result->receptionTime - signal.getSendingStart());
+        }
+        job.receiver->applyAnalogueModels(signal, job.frame->getPoa(), job.result->receiverPosition, job.result->receiverHeading, job.result->receptionTime, true);
+    });
+}
+
 // --Destruction--------------------------------
 
 BasePhyLayer::~BasePhyLayer()
@@ -28,6 +28,7 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <unordered_map>
 
 #include "veins/veins.h"
 
@@ -152,6 +153,21 @@ protected:
 
     BaseWorldUtility* world = nullptr; ///< Pointer to the World Utility, to obtain some global information
 
+    /**
+     * Signal of an AirFrame on its way to this module, filtered ahead of time by the sender (see prepareChannelCopies()).
+     */
+    struct PrecomputedSignal {
+        AntennaPosition receiverPosition; ///< antenna position of this module the signal was filtered for
+        Heading receiverHeading; ///< antenna heading of this module the signal was filtered for
+        simtime_t receptionTime; ///< time the signal was filtered for
+        Signal signal;
+    };
+
+    /**
+     * Signals filtered ahead of time, used by filterSignal() if this module's antenna did not move or turn in the meantime.
+     */
+    std::unordered_map<const AirFrame*, PrecomputedSignal> precomputedSignals;
+
 private:
     /**
      * Read the parameters of a XML element and stores them in the passed ParameterMap reference.
@@ -339,6 +355,25 @@ protected:
      */
     virtual void filterSignal(AirFrame* frame);
 
+    /**
+     * Add antenna gains to the passed signal and apply all analogueModels, evaluating positions at time now.
+     *
+     * If concurrently is set, AnalogueModel::filterSignalAt() is used, so this can run on worker threads.
+     */
+    void applyAnalogueModels(Signal& signal, const POA& senderPOA, const AntennaPosition& receiverPosition, const Heading& receiverHeading, simtime_t now, bool concurrently);
+
+    /**
+     * Return whether the signal of frames sent by a node with the passed antenna can be filtered for this module on worker threads.
+     */
+    virtual bool canFilterSignalConcurrently(const Antenna& senderAntenna) const;
+
+    /**
+     * Filter the signal of all copies of an AirFrame in parallel for all receivers that support this (if enabled in the ConnectionManager).
+     *
+     * Receivers use the result if their antenna did not move or turn until the frame arrives (see filterSignal()).
+     */
+    void prepareChannelCopies(const std::vector<ChannelCopy>& copies) override;
+
     /**
      * Called when the switching process of the Radio is finished.
      *
@@ -66,6 +66,14 @@ public:
         return p + v * dt.dbl();
     }
 
+    /**
+     * Get the unique identifier of the antenna (as returned by ChannelAccess::getId()).
+     */
+    int getId() const
+    {
+        return id;
+    }
+
     bool isSameAntenna(const AntennaPosition& o) const
     {
         ASSERT(!undef);
@@ -73,6 +81,14 @@ public:
         return (id == o.id);
     }
 
+    /**
+     * Returns true if both describe the same antenna with bit-identical position, speed, and time (unlike Coord::operator==, without any epsilon).
+     */
+    bool isIdenticalTo(const AntennaPosition& o) const
+    {
+        return (id == o.id) && (undef == o.undef) && (t == o.t) && (p.x == o.p.x) && (p.y == o.p.y) && (p.z == o.p.z) && (v.x == o.v.x) && (v.y == o.v.y) && (v.z == o.v.z);
+    }
+
 protected:
     int id; /**< unique identifier of antenna returned by ChannelAccess::getId() */
     Coord p; /**< position for linear extrapolation */
@@ -0,0 +1,108 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <cmath>
+
+#include "veins/base/utils/CounterBasedRNG.h"
+
+using veins::CounterBasedRNG;
+
+namespace {
+
+const uint32_t multiplier0 = 0xD2511F53;
+const uint32_t multiplier1 = 0xCD9E8D57;
+const uint32_t weyl0 = 0x9E3779B9;
+const uint32_t weyl1 = 0xBB67AE85;
+
+} // anonymous namespace
+
+CounterBasedRNG::CounterBasedRNG(uint64_t seed, const Block& streamId)
+{
+    // derive one key per stream by encrypting its id with the seed, so all streams can use the same counters
+    const Block derived = philox(streamId, {static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)});
+    key = {derived[0], derived[1]};
+}
+
+CounterBasedRNG::Block CounterBasedRNG::philox(Block counter, Key key)
+{
+    for (int round = 0; round < 10; ++round) {
+        if (round > 0) {
+            key[0] += weyl0;
+            key[1] += weyl1;
+        }
+        const uint64_t product0 = static_cast<uint64_t>(multiplier0) * counter[0];
+        const uint64_t product1 = static_cast<uint64_t>(multiplier1) * counter[2];
+        counter = {
+            static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+            static_cast<uint32_t>(product1),
+            static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+            static_cast<uint32_t>(product0)};
+    }
+    return counter;
+}
+
+uint32_t CounterBasedRNG::nextBits()
+{
+    if (used == block.size()) {
+        block = philox({counter++, 0, 0, 0}, key);
+        used = 0;
+    }
+    return block[used++];
+}
+
+double CounterBasedRNG::uniformPositive()
+{
+    const uint64_t high = nextBits();
+    const uint64_t low = nextBits();
+    // 52 bits, so adding 0.5 is exact and the result is never 0 or 1
+    const uint64_t bits = ((high << 32) | low) >> 12;
+    return std::ldexp(bits + 0.5, -52);
+}
+
+double CounterBasedRNG::normal()
+{
+    const double u1 = uniformPositive();
+    const double u2 = uniformPositive();
+    return std::sqrt(-2 * std::log(u1)) * std::cos(2 * M_PI * u2);
+}
+
+double CounterBasedRNG::gamma(double alpha, double theta)
+{
+    ASSERT(alpha > 0);
+    if (alpha < 1) {
+        // boost to alpha + 1 (see Marsaglia and Tsang, 2000)
+        const double boosted = gamma(alpha + 1, theta);
+        return boosted * std::pow(uniformPositive(), 1 / alpha);
+    }
+
+    const double d = alpha - 1.0 / 3;
+    const double c = 1 / std::sqrt(9 * d);
+    while (true) {
+        const double x = normal();
+        double v = 1 + c * x;
+        if (v <= 0) continue;
+        v = v * v * v;
+        const double u = uniformPositive();
+        if (u < 1 - 0.0331 * x * x * x * x) return d * v * theta;
+        if (std::log(u) < 0.5 * x * x + d * (1 - v + std::log(v))) return d * v * theta;
+    }
+}
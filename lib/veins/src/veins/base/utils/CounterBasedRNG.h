@@ -0,0 +1,83 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "veins/veins.h"
+
+namespace veins {
+
+/**
+ * Counter-based random number generator (Philox4x32-10, see J. Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3", SC 2011).
+ *
+ * Every number is a pure function of the seed, the stream id, and its position within the stream.
+ * Streams (e.g., one per link and frame) can therefore be evaluated in any order and on any thread, with bit-identical results,
+ * independent of how many numbers were drawn from other streams before.
+ *
+ * Distributions are implemented here (rather than taken from <random> or OMNeT++) so results do not depend on any library version.
+ */
+class VEINS_API CounterBasedRNG {
+public:
+    using Block = std::array<uint32_t, 4>;
+    using Key = std::array<uint32_t, 2>;
+
+    /**
+     * stream of random numbers identified by the (run) seed and an arbitrary 128 bit stream id
+     */
+    CounterBasedRNG(uint64_t seed, const Block& streamId);
+
+    /**
+     * apply the Philox4x32-10 bijection to counter, using key
+     */
+    static Block philox(Block counter, Key key);
+
+    /**
+     * next 32 random bits
+     */
+    uint32_t nextBits();
+
+    /**
+     * uniformly distributed in (0, 1), with 52 bits of resolution
+     */
+    double uniformPositive();
+
+    /**
+     * standard normal distribution (Box-Muller)
+     */
+    double normal();
+
+    /**
+     * gamma distribution with shape alpha and scale theta, as OMNeT++ gamma_d() (Marsaglia-Tsang)
+     */
+    double gamma(double alpha, double theta);
+
+private:
+    Key key; /**< derived from seed and stream id */
+    uint32_t counter = 0; /**< index of the next block of the stream */
+    Block block; /**< current block of random bits */
+    size_t used = 4; /**< number of words of block already returned */
+};
+
+} // namespace veins
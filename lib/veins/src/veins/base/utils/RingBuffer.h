@@ -0,0 +1,108 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "veins/veins.h"
+
+namespace veins {
+
+/**
+ * FIFO queue in a single contiguous buffer (drop-in for the subset of std::queue used in Veins).
+ *
+ * The buffer is allocated once with the initial capacity.
+ * Pushing to a full queue doubles the capacity, so queues with a known maximum size never reallocate.
+ */
+template <typename T>
+class VEINS_API RingBuffer {
+public:
+    explicit RingBuffer(size_t capacity = 0)
+        : buffer(capacity)
+    {
+    }
+
+    bool empty() const
+    {
+        return count == 0;
+    }
+
+    size_t size() const
+    {
+        return count;
+    }
+
+    size_t capacity() const
+    {
+        return buffer.size();
+    }
+
+    T& front()
+    {
+        ASSERT(!empty());
+        return buffer[head];
+    }
+
+    const T& front() const
+    {
+        ASSERT(!empty());
+        return buffer[head];
+    }
+
+    void push(T value)
+    {
+        if (count == buffer.size()) grow();
+        size_t tail = head + count;
+        if (tail >= buffer.size()) tail -= buffer.size();
+        buffer[tail] = std::move(value);
+        ++count;
+    }
+
+    void pop()
+    {
+        ASSERT(!empty());
+        buffer[head] = T();
+        if (++head == buffer.size()) head = 0;
+        --count;
+    }
+
+private:
+    void grow()
+    {
+        std::vector<T> grown(std::max<size_t>(4, buffer.size() * 2));
+        for (size_t i = 0; i < count; ++i) {
+            size_t from = head + i;
+            if (from >= buffer.size()) from -= buffer.size();
+            grown[i] = std::move(buffer[from]);
+        }
+        buffer.swap(grown);
+        head = 0;
+    }
+
+    std::vector<T> buffer;
+    size_t head = 0; /**< position of the front element in buffer */
+    size_t count = 0; /**< number of elements in buffer */
+};
+
+} // namespace veins
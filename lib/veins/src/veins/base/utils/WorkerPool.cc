@@ -0,0 +1,102 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "veins/base/utils/WorkerPool.h"
+
+using veins::WorkerPool;
+
+WorkerPool::WorkerPool(size_t numThreads)
+{
+    for (size_t i = 0; i < numThreads; ++i) {
+        threads.emplace_back(&WorkerPool::workLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    started.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkerPool::parallelFor(size_t n, const std::function<void(size_t)>& task)
+{
+    if (n == 0) return;
+    if (threads.empty() || n == 1) {
+        for (size_t i = 0; i < n; ++i) task(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->task = &task;
+        numTasks = n;
+        nextTask = 0;
+        error = nullptr;
+        numBusy = threads.size();
+        ++batch;
+    }
+    started.notify_all();
+
+    runTasks();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return numBusy == 0; });
+    this->task = nullptr;
+    if (error) std::rethrow_exception(error);
+}
+
+void WorkerPool::workLoop()
+{
+    size_t lastBatch = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            started.wait(lock, [this, lastBatch] { return stopping || batch != lastBatch; });
+            if (stopping) return;
+            lastBatch = batch;
+        }
+
+        runTasks();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--numBusy == 0) finished.notify_one();
+    }
+}
+
+void WorkerPool::runTasks()
+{
+    for (size_t i = nextTask++; i < numTasks; i = nextTask++) {
+        try {
+            (*task)(i);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) error = std::current_exception();
+        }
+    }
+}
@@ -0,0 +1,81 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "veins/veins.h"
+
+namespace veins {
+
+/**
+ * Fixed set of worker threads that run batches of independent tasks.
+ *
+ * Tasks must not use simulation services (scheduling, signals, RNGs, logging, ...), only plain computations.
+ */
+class VEINS_API WorkerPool {
+public:
+    /**
+     * start numThreads worker threads (the thread calling parallelFor() helps, too)
+     */
+    explicit WorkerPool(size_t numThreads);
+    ~WorkerPool();
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    size_t getNumThreads() const
+    {
+        return threads.size();
+    }
+
+    /**
+     * run task(i) for all i in [0, n) and wait until all of them finished
+     *
+     * If tasks threw, the first exception is rethrown (after all other tasks finished).
+     */
+    void parallelFor(size_t n, const std::function<void(size_t)>& task);
+
+private:
+    void workLoop();
+    void runTasks();
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable started;
+    std::condition_variable finished;
+    const std::function<void(size_t)>* task = nullptr;
+    size_t numTasks = 0;
+    std::atomic<size_t> nextTask{0};
+    size_t batch = 0; /**< number of the current batch, workers wait for it to change (guarded by mutex) */
+    size_t numBusy = 0; /**< worker threads that did not finish the current batch yet (guarded by mutex) */
+    std::exception_ptr error; /**< guarded by mutex */
+    bool stopping = false; /**< guarded by mutex */
+};
+
+} // namespace veins
@@ -23,6 +23,8 @@
 
 #include "veins/modules/analogueModel/NakagamiFading.h"
 
+#include "veins/base/utils/CounterBasedRNG.h"
+
 using namespace veins;
 
 /**
@@ -30,8 +32,13 @@ using namespace veins;
  */
 void NakagamiFading::filterSignal(Signal* signal)
 {
-    auto senderPos = signal->getSenderPoa().pos.getPositionAt();
-    auto receiverPos = signal->getReceiverPoa().pos.getPositionAt();
+    filterSignalAt(signal, simTime());
+}
+
+void NakagamiFading::filterSignalAt(Signal* signal, simtime_t now)
+{
+    auto senderPos = signal->getSenderPoa().pos.getPositionAt(now);
+    auto receiverPos = signal->getReceiverPoa().pos.getPositionAt(now);
 
     const double M_CLOSE = 1.5;
     const double M_FAR = 0.75;
@@ -57,7 +64,16 @@ void NakagamiFading::filterSignal(Signal* signal)
     }
 
     // calculate average RX power
-    double recvPower_mW = (RNGCONTEXT gamma_d(m, sendPower_mW / 1000 / m)) * 1000.0;
+    double recvPower_mW;
+    if (counterBasedRng) {
+        // one stream per link and frame (a sender never starts two frames at the same time)
+        const int64_t sendingStart = signal->getSendingStart().raw();
+        CounterBasedRNG rng(seed, {static_cast<uint32_t>(signal->getSenderPoa().pos.getId()), static_cast<uint32_t>(signal->getReceiverPoa().pos.getId()), static_cast<uint32_t>(sendingStart), static_cast<uint32_t>(sendingStart >> 32)});
+        recvPower_mW = rng.gamma(m, sendPower_mW / 1000 / m) * 1000.0;
+    }
+    else {
+        recvPower_mW = (RNGCONTEXT gamma_d(m, sendPower_mW / 1000 / m)) * 1000.0;
+    }
     if (recvPower_mW > sendPower_mW) {
         recvPower_mW = sendPower_mW;
     }
@@ -38,6 +38,10 @@ namespace veins {
  * An in-depth description of the model is available at:
  * Todo: add paper
  *
+ * If counterBasedRng is set, fading is drawn from a CounterBasedRNG keyed by the run's seed set, sender, receiver, and the frame's sending start
+ * (instead of the module's RNG), so it does not depend on the order in which receptions are evaluated.
+ * This allows filtering signals on worker threads (see AnalogueModel::canFilterConcurrently).
+ *
  * @author David Eckhoff, Christoph Sommer
  *
  * @ingroup analogueModels
@@ -45,10 +49,12 @@ namespace veins {
 class VEINS_API NakagamiFading : public AnalogueModel {
 
 public:
-    NakagamiFading(cComponent* owner, bool constM, double m)
+    NakagamiFading(cComponent* owner, bool constM, double m, bool counterBasedRng = false, uint64_t seed = 0)
         : AnalogueModel(owner)
         , constM(constM)
         , m(m)
+        , counterBasedRng(counterBasedRng)
+        , seed(seed)
     {
     }
 
@@ -58,12 +64,25 @@ public:
 
     void filterSignal(Signal* signal) override;
 
+    bool canFilterConcurrently() const override
+    {
+        return counterBasedRng;
+    }
+
+    void filterSignalAt(Signal* signal, simtime_t now) override;
+
 protected:
     /** @brief Whether to use a constant m or a m based on distance */
     bool constM;
 
     /** @brief The value of the coefficient m */
     double m;
+
+    /** @brief Whether to draw from a CounterBasedRNG instead of the module's RNG */
+    bool counterBasedRng;
+
+    /** @brief Seed of the CounterBasedRNG */
+    uint64_t seed;
 };
 
 } // namespace veins
@@ -46,3 +46,20 @@ void SimpleObstacleShadowing::filterSignal(Signal* signal)
 
     *signal *= factor;
 }
+
+void SimpleObstacleShadowing::prepareConcurrentFiltering()
+{
+    obstacleControl.prepareConcurrentAttenuation();
+}
+
+void SimpleObstacleShadowing::filterSignalAt(Signal* signal, simtime_t now)
+{
+    auto senderPos = signal->getSenderPoa().pos.getPositionAt(now);
+    auto receiverPos = signal->getReceiverPoa().pos.getPositionAt(now);
+
+    double factor = obstacleControl.calculateAttenuationConcurrently(senderPos, receiverPos);
+
+    EV_TRACE << "value is: " << factor << endl;
+
+    *signal *= factor;
+}
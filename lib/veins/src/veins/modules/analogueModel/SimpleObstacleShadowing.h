@@ -78,6 +78,15 @@ public:
     {
         return true;
     }
+
+    bool canFilterConcurrently() const override
+    {
+        return true;
+    }
+
+    void prepareConcurrentFiltering() override;
+
+    void filterSignalAt(Signal* signal, simtime_t now) override;
 };
 
 } // namespace veins
@@ -32,8 +32,13 @@ using veins::AirFrame;
 
 void SimplePathlossModel::filterSignal(Signal* signal)
 {
-    auto senderPos = signal->getSenderPoa().pos.getPositionAt();
-    auto receiverPos = signal->getReceiverPoa().pos.getPositionAt();
+    filterSignalAt(signal, simTime());
+}
+
+void SimplePathlossModel::filterSignalAt(Signal* signal, simtime_t now)
+{
+    auto senderPos = signal->getSenderPoa().pos.getPositionAt(now);
+    auto receiverPos = signal->getReceiverPoa().pos.getPositionAt(now);
 
     /** Calculate the distance factor */
     double sqrDistance = useTorus ? receiverPos.sqrTorusDist(senderPos, playgroundSize) : receiverPos.sqrdist(senderPos);
@@ -95,6 +95,13 @@ public:
     {
         return true;
     }
+
+    bool canFilterConcurrently() const override
+    {
+        return true;
+    }
+
+    void filterSignalAt(Signal* signal, simtime_t now) override;
 };
 
 } // namespace veins
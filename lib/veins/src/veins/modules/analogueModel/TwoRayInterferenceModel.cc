@@ -27,8 +27,13 @@ using namespace veins;
 
 void TwoRayInterferenceModel::filterSignal(Signal* signal)
 {
-    auto senderPos = signal->getSenderPoa().pos.getPositionAt();
-    auto receiverPos = signal->getReceiverPoa().pos.getPositionAt();
+    filterSignalAt(signal, simTime());
+}
+
+void TwoRayInterferenceModel::filterSignalAt(Signal* signal, simtime_t now)
+{
+    auto senderPos = signal->getSenderPoa().pos.getPositionAt(now);
+    auto receiverPos = signal->getReceiverPoa().pos.getPositionAt(now);
 
     const Coord senderPos2D(senderPos.x, senderPos.y);
     const Coord receiverPos2D(receiverPos.x, receiverPos.y);
@@ -57,6 +57,13 @@ public:
 
     void filterSignal(Signal* signal) override;
 
+    bool canFilterConcurrently() const override
+    {
+        return true;
+    }
+
+    void filterSignalAt(Signal* signal, simtime_t now) override;
+
 protected:
     /** @brief stores the dielectric constant used for calculation */
     double epsilon_r;
@@ -22,12 +22,14 @@
 //
 
 #include "veins/modules/mac/ieee80211p/Mac1609_4.h"
+#include <algorithm>
 #include <iterator>
 
 #include "veins/modules/phy/DeciderResult80211.h"
 #include "veins/base/phyLayer/PhyToMacControlInfo.h"
 #include "veins/modules/messages/PhyControlMessage_m.h"
 #include "veins/modules/messages/AckTimeOutMessage_m.h"
+#include "veins/modules/utility/Profiler.h"
 
 using namespace veins;
 
@@ -72,21 +74,21 @@ void Mac1609_4::initialize(int stage)
         myId = getParentModule()->getParentModule()->getFullPath();
         // create two edca systems
 
-        myEDCA[ChannelType::control] = make_unique<EDCA>(this, ChannelType::control, par("queueSize"));
-        myEDCA[ChannelType::control]->myId = myId;
-        myEDCA[ChannelType::control]->myId.append(" CCH");
-        myEDCA[ChannelType::control]->createQueue(2, (((CWMIN_11P + 1) / 4) - 1), (((CWMIN_11P + 1) / 2) - 1), AC_VO);
-        myEDCA[ChannelType::control]->createQueue(3, (((CWMIN_11P + 1) / 2) - 1), CWMIN_11P, AC_VI);
-        myEDCA[ChannelType::control]->createQueue(6, CWMIN_11P, CWMAX_11P, AC_BE);
-        myEDCA[ChannelType::control]->createQueue(9, CWMIN_11P, CWMAX_11P, AC_BK);
-
-        myEDCA[ChannelType::service] = make_unique<EDCA>(this, ChannelType::service, par("queueSize"));
-        myEDCA[ChannelType::service]->myId = myId;
-        myEDCA[ChannelType::service]->myId.append(" SCH");
-        myEDCA[ChannelType::service]->createQueue(2, (((CWMIN_11P + 1) / 4) - 1), (((CWMIN_11P + 1) / 2) - 1), AC_VO);
-        myEDCA[ChannelType::service]->createQueue(3, (((CWMIN_11P + 1) / 2) - 1), CWMIN_11P, AC_VI);
-        myEDCA[ChannelType::service]->createQueue(6, CWMIN_11P, CWMAX_11P, AC_BE);
-        myEDCA[ChannelType::service]->createQueue(9, CWMIN_11P, CWMAX_11P, AC_BK);
+        myEDCA[static_cast<size_t>(ChannelType::control)] = make_unique<EDCA>(this, ChannelType::control, par("queueSize"));
+        edca(ChannelType::control).myId = myId;
+        edca(ChannelType::control).myId.append(" CCH");
+        edca(ChannelType::control).createQueue(2, (((CWMIN_11P + 1) / 4) - 1), (((CWMIN_11P + 1) / 2) - 1), AC_VO);
+        edca(ChannelType::control).createQueue(3, (((CWMIN_11P + 1) / 2) - 1), CWMIN_11P, AC_VI);
+        edca(ChannelType::control).createQueue(6, CWMIN_11P, CWMAX_11P, AC_BE);
+        edca(ChannelType::control).createQueue(9, CWMIN_11P, CWMAX_11P, AC_BK);
+
+        myEDCA[static_cast<size_t>(ChannelType::service)] = make_unique<EDCA>(this, ChannelType::service, par("queueSize"));
+        edca(ChannelType::service).myId = myId;
+        edca(ChannelType::service).myId.append(" SCH");
+        edca(ChannelType::service).createQueue(2, (((CWMIN_11P + 1) / 4) - 1), (((CWMIN_11P + 1) / 2) - 1), AC_VO);
+        edca(ChannelType::service).createQueue(3, (((CWMIN_11P + 1) / 2) - 1), CWMIN_11P, AC_VI);
+        edca(ChannelType::service).createQueue(6, CWMIN_11P, CWMAX_11P, AC_BE);
+        edca(ChannelType::service).createQueue(9, CWMIN_11P, CWMAX_11P, AC_BK);
 
         useSCH = par("useServiceChannel").boolValue();
         if (useSCH) {
@@ -162,6 +164,7 @@ void Mac1609_4::initialize(int stage)
 
 void Mac1609_4::handleSelfMsg(cMessage* msg)
 {
+    VEINS_PROFILE_SCOPE_KIND("Mac1609_4::handleSelfMsg", msg->getKind());
     if (msg == stopIgnoreChannelStateMsg) {
         ignoreChannelState = false;
         return;
@@ -199,7 +202,7 @@ void Mac1609_4::handleSelfMsg(cMessage* msg)
 
         // we actually came to the point where we can send a packet
         channelBusySelf(true);
-        BaseFrame1609_4* pktToSend = myEDCA[activeChannel]->initiateTransmit(lastIdle);
+        BaseFrame1609_4* pktToSend = edca(activeChannel).initiateTransmit(lastIdle);
         ASSERT(pktToSend);
 
         lastAC = mapUserPriority(pktToSend->getUserPriority());
@@ -255,16 +258,16 @@ void Mac1609_4::handleSelfMsg(cMessage* msg)
                 // sifs + slot + rx_delay: see 802.11-2012 9.3.2.8 (32us + 13us + 49us = 94us)
                 simtime_t ackWaitTime(94, SIMTIME_US);
                 // update id in the retransmit timer
-                myEDCA[activeChannel]->myQueues[lastAC].ackTimeOut->setWsmId(pktToSend->getTreeId());
+                edca(activeChannel).myQueues[lastAC].ackTimeOut->setWsmId(pktToSend->getTreeId());
                 simtime_t timeOut = sendingDuration + ackWaitTime;
-                scheduleAt(simTime() + timeOut, myEDCA[activeChannel]->myQueues[lastAC].ackTimeOut);
+                scheduleAt(simTime() + timeOut, edca(activeChannel).myQueues[lastAC].ackTimeOut);
             }
         }
         else { // not enough time left now
             EV_TRACE << "Too little Time left. This packet cannot be send in this slot." << std::endl;
             statsNumTooLittleTime++;
             // revoke TXOP
-            myEDCA[activeChannel]->revokeTxOPs();
+            edca(activeChannel).revokeTxOPs();
             delete mac;
             channelIdle();
             // do nothing. contention will automatically start after channel switch
@@ -297,7 +300,7 @@ void Mac1609_4::handleUpperMsg(cMessage* msg)
         chan = ChannelType::service;
     }
 
-    int num = myEDCA[chan]->queuePacket(ac, thisMsg);
+    int num = edca(chan).queuePacket(ac, thisMsg);
 
     // packet was dropped in Mac
     if (num == -1) {
@@ -317,7 +320,7 @@ void Mac1609_4::handleUpperMsg(cMessage* msg)
 
     if (num == 1 && idleChannel == true && chan == activeChannel) {
 
-        simtime_t nextEvent = myEDCA[chan]->startContent(lastIdle, guardActive());
+        simtime_t nextEvent = edca(chan).startContent(lastIdle, guardActive());
 
         if (nextEvent != -1) {
             if ((!useSCH) || (nextEvent <= nextChannelSwitch->getArrivalTime())) {
@@ -330,7 +333,7 @@ void Mac1609_4::handleUpperMsg(cMessage* msg)
             else {
                 EV_TRACE << "Too little time in this interval. Will not schedule nextMacEvent" << std::endl;
                 // it is possible that this queue has an txop. we have to revoke it
-                myEDCA[activeChannel]->revokeTxOPs();
+                edca(activeChannel).revokeTxOPs();
                 statsNumTooLittleTime++;
             }
         }
@@ -338,8 +341,8 @@ void Mac1609_4::handleUpperMsg(cMessage* msg)
             cancelEvent(nextMacEvent);
         }
     }
-    if (num == 1 && idleChannel == false && myEDCA[chan]->myQueues[ac].currentBackoff == 0 && chan == activeChannel) {
-        myEDCA[chan]->backoff(ac);
+    if (num == 1 && idleChannel == false && edca(chan).myQueues[ac].currentBackoff == 0 && chan == activeChannel) {
+        edca(chan).backoff(ac);
     }
 }
 
@@ -366,7 +369,7 @@ void Mac1609_4::handleLowerControl(cMessage* msg)
         if (!dynamic_cast<Mac80211Ack*>(lastMac.get())) {
             // message was sent
             // update EDCA queue. go into post-transmit backoff and set cwCur to cwMin
-            myEDCA[activeChannel]->postTransmit(lastAC, lastWSM, useAcks);
+            edca(activeChannel).postTransmit(lastAC, lastWSM, useAcks);
         }
         // channel just turned idle.
         // don't set the chan to idle. the PHY layer decides, not us.
@@ -425,10 +428,10 @@ void Mac1609_4::setActiveChannel(ChannelType state)
 
 void Mac1609_4::finish()
 {
-    for (auto&& p : myEDCA) {
-        statsNumInternalContention += p.second->statsNumInternalContention;
-        statsNumBackoff += p.second->statsNumBackoff;
-        statsSlotsBackoff += p.second->statsSlotsBackoff;
+    for (auto&& e : myEDCA) {
+        statsNumInternalContention += e->statsNumInternalContention;
+        statsNumBackoff += e->statsNumBackoff;
+        statsSlotsBackoff += e->statsSlotsBackoff;
     }
 
     recordScalar("ReceivedUnicastPackets", statsReceivedPackets);
@@ -463,6 +466,10 @@ Mac1609_4::~Mac1609_4()
         cancelAndDelete(stopIgnoreChannelStateMsg);
         stopIgnoreChannelStateMsg = nullptr;
     }
+
+    for (auto observer : channelBusyObservers) {
+        observer->observedMac = nullptr;
+    }
 };
 
 void Mac1609_4::sendFrame(Mac80211Pkt* frame, simtime_t delay, Channel channelNr, MCS mcs, double txPower_mW)
@@ -563,6 +570,7 @@ void Mac1609_4::handleBroadcast(Mac80211Pkt* macPkt, DeciderResult80211* res)
 
 void Mac1609_4::handleLowerMsg(cMessage* msg)
 {
+    VEINS_PROFILE_SCOPE("Mac1609_4::handleLowerMsg");
     Mac80211Pkt* macPkt = check_and_cast<Mac80211Pkt*>(msg);
 
     // pass information about received frame to the upper layers
@@ -637,11 +645,11 @@ int Mac1609_4::EDCA::queuePacket(t_access_category ac, BaseFrame1609_4* msg)
 void Mac1609_4::EDCA::createQueue(int aifsn, int cwMin, int cwMax, t_access_category ac)
 {
 
-    if (myQueues.find(ac) != myQueues.end()) {
+    if (myQueues[ac].ackTimeOut != nullptr) {
         throw cRuntimeError("You can only add one queue per Access Category per EDCA subsystem");
     }
 
-    EDCAQueue newQueue(aifsn, cwMin, cwMax, ac);
+    EDCAQueue newQueue(aifsn, cwMin, cwMax, ac, maxQueueSize);
     myQueues[ac] = newQueue;
 }
 
@@ -685,24 +693,25 @@ BaseFrame1609_4* Mac1609_4::EDCA::initiateTransmit(simtime_t lastIdle)
     // As t_access_category is sorted by priority, we iterate back to front.
     // This realizes the behavior documented in IEEE Std 802.11-2012 Section 9.2.4.2; that is, "data frames from the higher priority AC" win an internal collision.
     // The phrase "EDCAF of higher UP" of IEEE Std 802.11-2012 Section 9.19.2.3 is assumed to be meaningless.
-    for (auto iter = myQueues.rbegin(); iter != myQueues.rend(); iter++) {
-        if (iter->second.queue.size() != 0 && !iter->second.waitForAck) {
-            if (idleTime >= iter->second.aifsn * SLOTLENGTH_11P + SIFS_11P && iter->second.txOP == true) {
+    for (size_t i = myQueues.size(); i-- > 0;) {
+        auto& edcaQueue = myQueues[i];
+        if (edcaQueue.queue.size() != 0 && !edcaQueue.waitForAck) {
+            if (idleTime >= edcaQueue.aifsn * SLOTLENGTH_11P + SIFS_11P && edcaQueue.txOP == true) {
 
-                EV_TRACE << "Queue " << iter->first << " is ready to send!" << std::endl;
+                EV_TRACE << "Queue " << i << " is ready to send!" << std::endl;
 
-                iter->second.txOP = false;
+                edcaQueue.txOP = false;
                 // this queue is ready to send
                 if (pktToSend == nullptr) {
-                    pktToSend = iter->second.queue.front();
+                    pktToSend = edcaQueue.queue.front();
                 }
                 else {
                     // there was already another packet ready. we have to go increase cw and go into backoff. It's called internal contention and its wonderful
 
                     statsNumInternalContention++;
-                    iter->second.cwCur = std::min(iter->second.cwMax, (iter->second.cwCur + 1) * 2 - 1);
-                    iter->second.currentBackoff = owner->intuniform(0, iter->second.cwCur);
-                    EV_TRACE << "Internal contention for queue " << iter->first << " : " << iter->second.currentBackoff << ". Increase cwCur to " << iter->second.cwCur << std::endl;
+                    edcaQueue.cwCur = std::min(edcaQueue.cwMax, (edcaQueue.cwCur + 1) * 2 - 1);
+                    edcaQueue.currentBackoff = owner->intuniform(0, edcaQueue.cwCur);
+                    EV_TRACE << "Internal contention for queue " << i << " : " << edcaQueue.currentBackoff << ". Increase cwCur to " << edcaQueue.cwCur << std::endl;
                 }
             }
         }
@@ -730,9 +739,8 @@ simtime_t Mac1609_4::EDCA::startContent(simtime_t idleSince, bool guardActive)
 
     // this returns the nearest possible event in this EDCA subsystem after a busy channel
 
-    for (auto&& p : myQueues) {
-        auto& accessCategory = p.first;
-        auto& edcaQueue = p.second;
+    for (size_t accessCategory = 0; accessCategory < myQueues.size(); ++accessCategory) {
+        auto& edcaQueue = myQueues[accessCategory];
         if (edcaQueue.queue.size() != 0 && !edcaQueue.waitForAck) {
 
             /* 1609_4 says that when attempting to send (backoff == 0) when guard is active, a random backoff is invoked */
@@ -779,18 +787,17 @@ void Mac1609_4::EDCA::stopContent(bool allowBackoff, bool generateTxOp)
 
     lastStart = -1; // indicate that there was no last start
 
-    for (auto&& p : myQueues) {
-        auto& accessCategory = p.first;
-        auto& edcaQueue = p.second;
+    for (size_t accessCategory = 0; accessCategory < myQueues.size(); ++accessCategory) {
+        auto& edcaQueue = myQueues[accessCategory];
         if ((edcaQueue.currentBackoff != 0 || edcaQueue.queue.size() != 0) && !edcaQueue.waitForAck) {
             // check how many slots we already waited until the chan became busy
 
             int64_t oldBackoff = edcaQueue.currentBackoff;
 
-            std::string info;
+            const char* info = "";
             if (passedTime < edcaQueue.aifsn * SLOTLENGTH_11P + SIFS_11P) {
                 // we didnt even make it one DIFS :(
-                info.append(" No DIFS");
+                info = " No DIFS";
             }
             else {
                 // decrease the backoff by one because we made it longer than one DIFS
@@ -805,14 +812,14 @@ void Mac1609_4::EDCA::stopContent(bool allowBackoff, bool generateTxOp)
                     // this can be below 0 because of post transmit backoff -> backoff on empty queues will not generate macevents,
                     // we dont want to generate a txOP for empty queues
                     edcaQueue.currentBackoff -= std::min(edcaQueue.currentBackoff, passedSlots);
-                    info.append(" PostCommit Over");
+                    info = " PostCommit Over";
                 }
                 else {
                     edcaQueue.currentBackoff -= passedSlots;
                     if (edcaQueue.currentBackoff <= -1) {
                         if (generateTxOp) {
                             edcaQueue.txOP = true;
-                            info.append(" TXOP");
+                            info = " TXOP";
                         }
                         // else: this packet couldnt be sent because there was too little time. we could have generated a txop, but the channel switched
                         edcaQueue.currentBackoff = 0;
@@ -868,7 +875,7 @@ Mac1609_4::EDCA::EDCA(cSimpleModule* owner, ChannelType channelType, int maxQueu
 Mac1609_4::EDCA::~EDCA()
 {
     for (auto& q : myQueues) {
-        auto& ackTimeout = q.second.ackTimeOut;
+        auto& ackTimeout = q.ackTimeOut;
         if (ackTimeout) {
             owner->cancelAndDelete(ackTimeout);
             ackTimeout = nullptr;
@@ -878,8 +885,7 @@ Mac1609_4::EDCA::~EDCA()
 
 void Mac1609_4::EDCA::revokeTxOPs()
 {
-    for (auto&& p : myQueues) {
-        auto& edcaQueue = p.second;
+    for (auto& edcaQueue : myQueues) {
         if (edcaQueue.txOP == true) {
             edcaQueue.txOP = false;
             edcaQueue.currentBackoff = 0;
@@ -906,9 +912,9 @@ void Mac1609_4::channelBusySelf(bool generateTxOp)
     else {
         // the edca subsystem was not doing anything anyway.
     }
-    myEDCA[activeChannel]->stopContent(false, generateTxOp);
+    edca(activeChannel).stopContent(false, generateTxOp);
 
-    emit(sigChannelBusy, true);
+    notifyChannelBusy(true);
 }
 
 void Mac1609_4::channelBusy()
@@ -928,9 +934,9 @@ void Mac1609_4::channelBusy()
     else {
         // the edca subsystem was not doing anything anyway.
     }
-    myEDCA[activeChannel]->stopContent(true, false);
+    edca(activeChannel).stopContent(true, false);
 
-    emit(sigChannelBusy, true);
+    notifyChannelBusy(true);
 }
 
 void Mac1609_4::channelIdle(bool afterSwitch)
@@ -965,7 +971,7 @@ void Mac1609_4::channelIdle(bool afterSwitch)
     statsTotalBusyTime += simTime() - lastBusy;
 
     // get next Event from current EDCA subsystem
-    simtime_t nextEvent = myEDCA[activeChannel]->startContent(lastIdle, guardActive());
+    simtime_t nextEvent = edca(activeChannel).startContent(lastIdle, guardActive());
     if (nextEvent != -1) {
         if ((!useSCH) || (nextEvent < nextChannelSwitch->getArrivalTime())) {
             scheduleAt(nextEvent, nextMacEvent);
@@ -974,14 +980,43 @@ void Mac1609_4::channelIdle(bool afterSwitch)
         else {
             EV_TRACE << "Too little time in this interval. will not schedule macEvent" << std::endl;
             statsNumTooLittleTime++;
-            myEDCA[activeChannel]->revokeTxOPs();
+            edca(activeChannel).revokeTxOPs();
         }
     }
     else {
         EV_TRACE << "I don't have any new events in this EDCA sub system" << std::endl;
     }
 
-    emit(sigChannelBusy, false);
+    notifyChannelBusy(false);
+}
+
+void Mac1609_4::notifyChannelBusy(bool busy)
+{
+    emit(sigChannelBusy, busy);
+    for (auto observer : channelBusyObservers) {
+        observer->channelBusyChanged(simTime(), busy);
+    }
+}
+
+void Mac1609_4::addChannelBusyObserver(ChannelBusyObserver* observer)
+{
+    ASSERT(observer->observedMac == nullptr);
+    observer->observedMac = this;
+    channelBusyObservers.push_back(observer);
+}
+
+void Mac1609_4::removeChannelBusyObserver(ChannelBusyObserver* observer)
+{
+    ASSERT(observer->observedMac == this);
+    observer->observedMac = nullptr;
+    channelBusyObservers.erase(std::remove(channelBusyObservers.begin(), channelBusyObservers.end(), observer), channelBusyObservers.end());
+}
+
+Mac1609_4::ChannelBusyObserver::~ChannelBusyObserver()
+{
+    if (observedMac) {
+        observedMac->removeChannelBusyObserver(this);
+    }
 }
 
 void Mac1609_4::setParametersForBitrate(uint64_t bitrate)
@@ -1057,21 +1092,21 @@ void Mac1609_4::handleAck(const Mac80211Ack* ack)
 
     ChannelType chan = ChannelType::control;
     bool queueUnblocked = false;
-    for (auto&& p : myEDCA[chan]->myQueues) {
-        auto& accessCategory = p.first;
-        auto& edcaQueue = p.second;
+    for (size_t i = 0; i < edca(chan).myQueues.size(); ++i) {
+        auto accessCategory = static_cast<t_access_category>(i);
+        auto& edcaQueue = edca(chan).myQueues[i];
         if (edcaQueue.queue.size() > 0 && edcaQueue.waitForAck && (edcaQueue.waitOnUnicastID == ack->getMessageId())) {
             BaseFrame1609_4* wsm = edcaQueue.queue.front();
             edcaQueue.queue.pop();
             delete wsm;
-            myEDCA[chan]->myQueues[accessCategory].cwCur = myEDCA[chan]->myQueues[accessCategory].cwMin;
-            myEDCA[chan]->backoff(accessCategory);
+            edca(chan).myQueues[accessCategory].cwCur = edca(chan).myQueues[accessCategory].cwMin;
+            edca(chan).backoff(accessCategory);
             edcaQueue.ssrc = 0;
             edcaQueue.slrc = 0;
             edcaQueue.waitForAck = false;
             edcaQueue.waitOnUnicastID = -1;
-            if (myEDCA[chan]->myQueues[accessCategory].ackTimeOut->isScheduled()) {
-                cancelEvent(myEDCA[chan]->myQueues[accessCategory].ackTimeOut);
+            if (edca(chan).myQueues[accessCategory].ackTimeOut->isScheduled()) {
+                cancelEvent(edca(chan).myQueues[accessCategory].ackTimeOut);
             }
             queueUnblocked = true;
         }
@@ -1106,20 +1141,20 @@ void Mac1609_4::handleAckTimeOut(AckTimeOutMessage* ackTimeOutMsg)
 void Mac1609_4::handleRetransmit(t_access_category ac)
 {
     // cancel the acktime out
-    if (myEDCA[ChannelType::control]->myQueues[ac].ackTimeOut->isScheduled()) {
+    if (edca(ChannelType::control).myQueues[ac].ackTimeOut->isScheduled()) {
         // This case is possible if we received PHY_RX_END_WITH_SUCCESS or FAILURE even before ack timeout
-        cancelEvent(myEDCA[ChannelType::control]->myQueues[ac].ackTimeOut);
+        cancelEvent(edca(ChannelType::control).myQueues[ac].ackTimeOut);
     }
-    if (myEDCA[ChannelType::control]->myQueues[ac].queue.size() == 0) {
+    if (edca(ChannelType::control).myQueues[ac].queue.size() == 0) {
         throw cRuntimeError("Trying retransmission on empty queue...");
     }
-    BaseFrame1609_4* appPkt = myEDCA[ChannelType::control]->myQueues[ac].queue.front();
+    BaseFrame1609_4* appPkt = edca(ChannelType::control).myQueues[ac].queue.front();
     bool contend = false;
     bool retriesExceeded = false;
     // page 879 of IEEE 802.11-2012
     if (appPkt->getBitLength() <= dot11RTSThreshold) {
-        myEDCA[ChannelType::control]->myQueues[ac].ssrc++;
-        if (myEDCA[ChannelType::control]->myQueues[ac].ssrc <= dot11ShortRetryLimit) {
+        edca(ChannelType::control).myQueues[ac].ssrc++;
+        if (edca(ChannelType::control).myQueues[ac].ssrc <= dot11ShortRetryLimit) {
             retriesExceeded = false;
         }
         else {
@@ -1127,8 +1162,8 @@ void Mac1609_4::handleRetransmit(t_access_category ac)
         }
     }
     else {
-        myEDCA[ChannelType::control]->myQueues[ac].slrc++;
-        if (myEDCA[ChannelType::control]->myQueues[ac].slrc <= dot11LongRetryLimit) {
+        edca(ChannelType::control).myQueues[ac].slrc++;
+        if (edca(ChannelType::control).myQueues[ac].slrc <= dot11LongRetryLimit) {
             retriesExceeded = false;
         }
         else {
@@ -1137,16 +1172,16 @@ void Mac1609_4::handleRetransmit(t_access_category ac)
     }
     if (!retriesExceeded) {
         // try again!
-        myEDCA[ChannelType::control]->myQueues[ac].cwCur = std::min(myEDCA[ChannelType::control]->myQueues[ac].cwMax, (myEDCA[ChannelType::control]->myQueues[ac].cwCur * 2) + 1);
-        myEDCA[ChannelType::control]->backoff(ac);
+        edca(ChannelType::control).myQueues[ac].cwCur = std::min(edca(ChannelType::control).myQueues[ac].cwMax, (edca(ChannelType::control).myQueues[ac].cwCur * 2) + 1);
+        edca(ChannelType::control).backoff(ac);
         contend = true;
         // no need to reset wait on id here as we are still retransmitting same packet
-        myEDCA[ChannelType::control]->myQueues[ac].waitForAck = false;
+        edca(ChannelType::control).myQueues[ac].waitForAck = false;
     }
     else {
         // enough tries!
-        myEDCA[ChannelType::control]->myQueues[ac].queue.pop();
-        if (myEDCA[ChannelType::control]->myQueues[ac].queue.size() > 0) {
+        edca(ChannelType::control).myQueues[ac].queue.pop();
+        if (edca(ChannelType::control).myQueues[ac].queue.size() > 0) {
             // start contention only if there are more packets in the queue
             contend = true;
         }
@@ -1154,24 +1189,25 @@ void Mac1609_4::handleRetransmit(t_access_category ac)
         emit(sigRetriesExceeded, appPkt);
         statsRetriesExceeded++;
         delete appPkt;
-        myEDCA[ChannelType::control]->myQueues[ac].cwCur = myEDCA[ChannelType::control]->myQueues[ac].cwMin;
-        myEDCA[ChannelType::control]->backoff(ac);
-        myEDCA[ChannelType::control]->myQueues[ac].waitForAck = false;
-        myEDCA[ChannelType::control]->myQueues[ac].waitOnUnicastID = -1;
-        myEDCA[ChannelType::control]->myQueues[ac].ssrc = 0;
-        myEDCA[ChannelType::control]->myQueues[ac].slrc = 0;
+        edca(ChannelType::control).myQueues[ac].cwCur = edca(ChannelType::control).myQueues[ac].cwMin;
+        edca(ChannelType::control).backoff(ac);
+        edca(ChannelType::control).myQueues[ac].waitForAck = false;
+        edca(ChannelType::control).myQueues[ac].waitOnUnicastID = -1;
+        edca(ChannelType::control).myQueues[ac].ssrc = 0;
+        edca(ChannelType::control).myQueues[ac].slrc = 0;
     }
     waitUntilAckRXorTimeout = false;
     if (contend && idleChannel && !ignoreChannelState) {
         // reevaluate times -- if channel is not idle, then contention would start automatically
         cancelEvent(nextMacEvent);
-        simtime_t nextEvent = myEDCA[ChannelType::control]->startContent(lastIdle, guardActive());
+        simtime_t nextEvent = edca(ChannelType::control).startContent(lastIdle, guardActive());
         scheduleAt(nextEvent, nextMacEvent);
     }
 }
 
-Mac1609_4::EDCA::EDCAQueue::EDCAQueue(int aifsn, int cwMin, int cwMax, t_access_category ac)
-    : aifsn(aifsn)
+Mac1609_4::EDCA::EDCAQueue::EDCAQueue(int aifsn, int cwMin, int cwMax, t_access_category ac, size_t capacity)
+    : queue(capacity)
+    , aifsn(aifsn)
     , cwMin(cwMin)
     , cwMax(cwMax)
     , cwCur(cwMin)
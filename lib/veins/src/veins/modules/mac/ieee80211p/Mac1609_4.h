@@ -22,9 +22,11 @@
 
 #pragma once
 
-#include <queue>
+#include <array>
+#include <set>
 #include <memory>
 #include <stdint.h>
+#include <vector>
 
 #include "veins/veins.h"
 
@@ -34,6 +36,7 @@
 #include "veins/modules/utility/Consts80211p.h"
 #include "veins/modules/utility/MacToPhyControlInfo11p.h"
 #include "veins/base/utils/FindModule.h"
+#include "veins/base/utils/RingBuffer.h"
 #include "veins/modules/messages/Mac80211Pkt_m.h"
 #include "veins/modules/messages/BaseFrame1609_4_m.h"
 #include "veins/modules/messages/AckTimeOutMessage_m.h"
@@ -86,28 +89,30 @@ public:
         AC_VI = 2,
         AC_VO = 3
     };
+    static constexpr size_t numAccessCategories = 4;
+    static constexpr size_t numChannelTypes = 2;
 
     class VEINS_API EDCA : HasLogProxy {
     public:
         class VEINS_API EDCAQueue {
         public:
-            std::queue<BaseFrame1609_4*> queue;
-            int aifsn; // number of aifs slots for this queue
-            int cwMin; // minimum contention window
-            int cwMax; // maximum contention size
-            int cwCur; // current contention window
-            int64_t currentBackoff; // current Backoff value for this queue
-            bool txOP;
-            int ssrc; // station short retry count
-            int slrc; // station long retry count
-            bool waitForAck; // true if the queue is waiting for an acknowledgment for unicast
-            unsigned long waitOnUnicastID; // unique id of unicast on which station is waiting
-            AckTimeOutMessage* ackTimeOut; // timer for retransmission on receiving no ACK
+            RingBuffer<BaseFrame1609_4*> queue;
+            int aifsn = 0; // number of aifs slots for this queue
+            int cwMin = 0; // minimum contention window
+            int cwMax = 0; // maximum contention size
+            int cwCur = 0; // current contention window
+            int64_t currentBackoff = 0; // current Backoff value for this queue
+            bool txOP = false;
+            int ssrc = 0; // station short retry count
+            int slrc = 0; // station long retry count
+            bool waitForAck = false; // true if the queue is waiting for an acknowledgment for unicast
+            unsigned long waitOnUnicastID = -1; // unique id of unicast on which station is waiting
+            AckTimeOutMessage* ackTimeOut = nullptr; // timer for retransmission on receiving no ACK; nullptr until the queue is created
 
             EDCAQueue()
             {
             }
-            EDCAQueue(int aifsn, int cwMin, int cwMax, t_access_category ac);
+            EDCAQueue(int aifsn, int cwMin, int cwMax, t_access_category ac, size_t capacity = 0);
             ~EDCAQueue();
         };
 
@@ -127,7 +132,7 @@ public:
 
     public:
         cSimpleModule* owner;
-        std::map<t_access_category, EDCAQueue> myQueues;
+        std::array<EDCAQueue, numAccessCategories> myQueues; // indexed by access category
         uint32_t maxQueueSize;
         simtime_t lastStart; // when we started the last contention;
         ChannelType channelType;
@@ -141,14 +146,47 @@ public:
         std::string myId;
     };
 
+    /**
+     * @brief Gets notified directly whenever the channel turns busy or idle.
+     *
+     * Cheaper than subscribing to sigChannelBusy, as no signal is propagated up the module hierarchy.
+     * Observers are removed from the MAC when they are deleted (and vice versa).
+     */
+    class VEINS_API ChannelBusyObserver {
+    public:
+        virtual ~ChannelBusyObserver();
+
+        /**
+         * @brief Called whenever the channel turns busy or idle.
+         *
+         * @param time the time of the transition
+         * @param busy whether the channel turned busy (or idle)
+         */
+        virtual void channelBusyChanged(simtime_t time, bool busy) = 0;
+
+    private:
+        friend class Mac1609_4;
+        Mac1609_4* observedMac = nullptr;
+    };
+
 public:
     Mac1609_4()
         : nextChannelSwitch(nullptr)
         , nextMacEvent(nullptr)
+        , stopIgnoreChannelStateMsg(nullptr)
     {
     }
     ~Mac1609_4() override;
 
+    /**
+     * @brief Notify the given observer of all channel busy/idle transitions (in addition to emitting sigChannelBusy).
+     *
+     * An observer can only observe a single MAC at a time.
+     */
+    void addChannelBusyObserver(ChannelBusyObserver* observer);
+
+    void removeChannelBusyObserver(ChannelBusyObserver* observer);
+
     /**
      * @brief return true if alternate access is enabled
      */
@@ -229,6 +267,9 @@ protected:
     void channelBusySelf(bool generateTxOp);
     void channelIdle(bool afterSwitch = false);
 
+    /** @brief Signal a channel busy/idle transition to all listeners and observers. */
+    void notifyChannelBusy(bool busy);
+
     void setParametersForBitrate(uint64_t bitrate);
 
     void sendAck(LAddress::L2Type recpAddress, unsigned long wsmId);
@@ -271,7 +312,12 @@ protected:
     bool useSCH;
     Channel mySCH;
 
-    std::map<ChannelType, std::unique_ptr<EDCA>> myEDCA;
+    std::array<std::unique_ptr<EDCA>, numChannelTypes> myEDCA; // indexed by ChannelType, see edca()
+
+    EDCA& edca(ChannelType channel)
+    {
+        return *myEDCA[static_cast<size_t>(channel)];
+    }
 
     bool idleChannel;
 
@@ -318,6 +364,8 @@ protected:
     std::set<unsigned long> handledUnicastToApp;
 
     Mac80211pToPhy11pInterface* phy11p;
+
+    std::vector<ChannelBusyObserver*> channelBusyObservers;
 };
 
 } // namespace veins
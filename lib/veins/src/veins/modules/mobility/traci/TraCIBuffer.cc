@@ -40,30 +40,31 @@ TraCIBuffer::TraCIBuffer()
 }
 
 TraCIBuffer::TraCIBuffer(std::string buf)
-    : buf(buf)
+    : buf(buf.begin(), buf.end())
 {
     buf_index = 0;
 }
 
 bool TraCIBuffer::eof() const
 {
-    return buf_index == buf.length();
+    return buf_index == buf.size();
 }
 
 void TraCIBuffer::set(std::string buf)
 {
-    this->buf = buf;
+    this->buf.assign(buf.begin(), buf.end());
     buf_index = 0;
 }
 
 void TraCIBuffer::clear()
 {
-    set("");
+    buf.clear();
+    buf_index = 0;
 }
 
 std::string TraCIBuffer::str() const
 {
-    return buf;
+    return std::string(buf.begin(), buf.end());
 }
 
 template <>
@@ -83,7 +84,7 @@ std::vector<std::string> TraCIBuffer::readTypeChecked(int expectedTraCIType)
 std::string TraCIBuffer::hexStr() const
 {
     std::stringstream ss;
-    for (std::string::const_iterator i = buf.begin() + buf_index; i != buf.end(); ++i) {
+    for (std::vector<char>::const_iterator i = buf.begin() + buf_index; i != buf.end(); ++i) {
         if (i != buf.begin()) ss << " ";
         ss << std::hex << std::setw(2) << std::setfill('0') << (int) (uint8_t) *i;
     }
@@ -95,7 +96,7 @@ void TraCIBuffer::write(std::string inv)
 {
     uint32_t length = inv.length();
     write<uint32_t>(length);
-    for (size_t i = 0; i < length; ++i) write<char>(inv[i]);
+    buf.insert(buf.end(), inv.begin(), inv.end());
 }
 
 template <>
@@ -111,14 +112,8 @@ void TraCIBuffer::write(std::list<std::string> inv)
 template <>
 std::string TraCIBuffer::read()
 {
-    uint32_t length = read<uint32_t>();
-    if (length == 0) return std::string();
-    char obuf[length + 1];
-
-    for (size_t i = 0; i < length; ++i) read<char>(obuf[i]);
-    obuf[length] = 0;
-
-    return std::string(obuf, length);
+    TraCIStringView view = readStringView();
+    return std::string(view.data(), view.size());
 }
 
 template <>
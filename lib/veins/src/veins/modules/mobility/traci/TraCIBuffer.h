@@ -22,8 +22,11 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
+#include <cstring>
 #include <string>
+#include <vector>
 
 #include "veins/veins.h"
 
@@ -35,8 +38,115 @@ struct TraCICoord;
 
 bool VEINS_API isBigEndian();
 
+namespace traci_detail {
+
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__)
+constexpr bool hostIsBigEndian = (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__);
+#elif defined(_WIN32)
+constexpr bool hostIsBigEndian = false;
+#else
+const bool hostIsBigEndian = isBigEndian();
+#endif
+
+/**
+ * reverse the byte order of the N bytes at p (i.e., convert between host and network byte order on little-endian hosts)
+ */
+template <size_t N>
+inline void swapBytes(char* p)
+{
+    std::reverse(p, p + N);
+}
+
+#if defined(__GNUC__)
+template <>
+inline void swapBytes<2>(char* p)
+{
+    uint16_t v;
+    std::memcpy(&v, p, sizeof(v));
+    v = __builtin_bswap16(v);
+    std::memcpy(p, &v, sizeof(v));
+}
+
+template <>
+inline void swapBytes<4>(char* p)
+{
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    v = __builtin_bswap32(v);
+    std::memcpy(p, &v, sizeof(v));
+}
+
+template <>
+inline void swapBytes<8>(char* p)
+{
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    v = __builtin_bswap64(v);
+    std::memcpy(p, &v, sizeof(v));
+}
+#endif
+
+} // namespace traci_detail
+
+/**
+ * Non-owning reference to a string stored in a TraCIBuffer.
+ *
+ * Only valid as long as the buffer it was read from is neither modified nor destroyed.
+ */
+class VEINS_API TraCIStringView {
+public:
+    TraCIStringView() = default;
+    TraCIStringView(const char* data, size_t size)
+        : ptr(data)
+        , len(size)
+    {
+    }
+
+    const char* data() const
+    {
+        return ptr;
+    }
+
+    size_t size() const
+    {
+        return len;
+    }
+
+    bool empty() const
+    {
+        return len == 0;
+    }
+
+    char operator[](size_t i) const
+    {
+        return ptr[i];
+    }
+
+    std::string str() const
+    {
+        return std::string(ptr, len);
+    }
+
+    bool operator==(const std::string& other) const
+    {
+        return other.size() == len && std::memcmp(ptr, other.data(), len) == 0;
+    }
+
+    bool operator!=(const std::string& other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    const char* ptr = nullptr;
+    size_t len = 0;
+};
+
 /**
  * Byte-buffer that stores values in TraCI byte-order
+ *
+ * Values are copied in and out of a single contiguous byte vector as a whole.
+ * Its capacity is kept on clear(), so a buffer can be reused without reallocating.
  */
 class VEINS_API TraCIBuffer {
 public:
@@ -47,57 +157,54 @@ public:
     T read()
     {
         T buf_to_return;
-        unsigned char* p_buf_to_return = reinterpret_cast<unsigned char*>(&buf_to_return);
-
-        if (isBigEndian()) {
-            for (size_t i = 0; i < sizeof(buf_to_return); ++i) {
-                if (eof()) throw cRuntimeError("Attempted to read past end of byte buffer");
-                p_buf_to_return[i] = buf[buf_index++];
-            }
-        }
-        else {
-            for (size_t i = 0; i < sizeof(buf_to_return); ++i) {
-                if (eof()) throw cRuntimeError("Attempted to read past end of byte buffer");
-                p_buf_to_return[sizeof(buf_to_return) - 1 - i] = buf[buf_index++];
-            }
-        }
-
+        readBuffer(reinterpret_cast<unsigned char*>(&buf_to_return), sizeof(buf_to_return));
         return buf_to_return;
     }
 
     template <typename T>
     void write(T inv)
     {
-        unsigned char* p_buf_to_send = reinterpret_cast<unsigned char*>(&inv);
-
-        if (isBigEndian()) {
-            for (size_t i = 0; i < sizeof(inv); ++i) {
-                buf += p_buf_to_send[i];
-            }
-        }
-        else {
-            for (size_t i = 0; i < sizeof(inv); ++i) {
-                buf += p_buf_to_send[sizeof(inv) - 1 - i];
-            }
-        }
+        char* p_buf_to_send = reinterpret_cast<char*>(&inv);
+        if (!traci_detail::hostIsBigEndian) traci_detail::swapBytes<sizeof(inv)>(p_buf_to_send);
+        buf.insert(buf.end(), p_buf_to_send, p_buf_to_send + sizeof(inv));
     }
 
+    /**
+     * read size bytes, converting them from network to host byte order
+     */
     void readBuffer(unsigned char* buffer, size_t size)
     {
-        if (isBigEndian()) {
-            for (size_t i = 0; i < size; ++i) {
-                if (eof()) throw cRuntimeError("Attempted to read past end of byte buffer");
-                buffer[i] = buf[buf_index++];
-            }
-        }
-        else {
-            for (size_t i = 0; i < size; ++i) {
-                if (eof()) throw cRuntimeError("Attempted to read past end of byte buffer");
-                buffer[size - 1 - i] = buf[buf_index++];
-            }
+        const char* p = consume(size);
+        std::memcpy(buffer, p, size);
+        if (traci_detail::hostIsBigEndian) return;
+        switch (size) {
+        case 1:
+            break;
+        case 2:
+            traci_detail::swapBytes<2>(reinterpret_cast<char*>(buffer));
+            break;
+        case 4:
+            traci_detail::swapBytes<4>(reinterpret_cast<char*>(buffer));
+            break;
+        case 8:
+            traci_detail::swapBytes<8>(reinterpret_cast<char*>(buffer));
+            break;
+        default:
+            std::reverse(buffer, buffer + size);
         }
     }
 
+    /**
+     * read a string without copying it
+     *
+     * The returned view is only valid until this buffer is modified or destroyed.
+     */
+    TraCIStringView readStringView()
+    {
+        uint32_t length = read<uint32_t>();
+        return TraCIStringView(consume(length), length);
+    }
+
     template <typename T>
     T read(T& out)
     {
@@ -112,6 +219,16 @@ public:
         return *this;
     }
 
+    /**
+     * read a string, reusing the memory already held by out
+     */
+    TraCIBuffer& operator>>(std::string& out)
+    {
+        TraCIStringView view = readStringView();
+        out.assign(view.data(), view.size());
+        return *this;
+    }
+
     template <typename T>
     TraCIBuffer& operator<<(const T& inv)
     {
@@ -131,6 +248,34 @@ public:
         return read<T>();
     }
 
+    /**
+     * resize the buffer to size bytes (rewinding to its start) and return a pointer to its contents, e.g., for receiving a message into
+     */
+    char* prepare(size_t size)
+    {
+        buf.resize(size);
+        buf_index = 0;
+        return buf.data();
+    }
+
+    void reserve(size_t size)
+    {
+        buf.reserve(size);
+    }
+
+    /**
+     * returns the complete contents of the buffer (regardless of how much has been read)
+     */
+    const char* data() const
+    {
+        return buf.data();
+    }
+
+    size_t size() const
+    {
+        return buf.size();
+    }
+
     bool eof() const;
     void set(std::string buf);
     void clear();
@@ -146,7 +291,18 @@ public:
     }
 
 private:
-    std::string buf;
+    /**
+     * advance the read position by size bytes, returning a pointer to the skipped bytes
+     */
+    const char* consume(size_t size)
+    {
+        if (size > buf.size() - buf_index) throw cRuntimeError("Attempted to read past end of byte buffer");
+        const char* p = buf.data() + buf_index;
+        buf_index += size;
+        return p;
+    }
+
+    std::vector<char> buf;
     size_t buf_index;
     static bool timeAsDouble;
 };
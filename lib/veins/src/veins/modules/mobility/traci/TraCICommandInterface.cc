@@ -1599,4 +1599,147 @@ std::string TraCICommandInterface::Vehicle::getVType()
     return traci->genericGetString(CMD_GET_VEHICLE_VARIABLE, nodeId, VAR_TYPE, RESPONSE_GET_VEHICLE_VARIABLE);
 }
 
+template <typename T>
+TraCICommandInterface::Batch::Value<T> TraCICommandInterface::Batch::add(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId, uint8_t resultTypeId, std::function<T(TraCIBuffer&)> readValue)
+{
+    Value<T> value;
+    auto slot = value.slot;
+    commands.emplace_back(commandId, TraCIBuffer() << variableId << objectId);
+    readResponses.push_back([=](TraCIBuffer& buf) {
+        uint8_t cmdLength;
+        buf >> cmdLength;
+        if (cmdLength == 0) {
+            uint32_t cmdLengthX;
+            buf >> cmdLengthX;
+        }
+        uint8_t commandId_r;
+        buf >> commandId_r;
+        ASSERT(commandId_r == responseId);
+        uint8_t varId;
+        buf >> varId;
+        ASSERT(varId == variableId);
+        std::string objectId_r;
+        buf >> objectId_r;
+        ASSERT(objectId_r == objectId);
+        uint8_t resType_r;
+        buf >> resType_r;
+        ASSERT(resType_r == resultTypeId);
+        slot->value = readValue(buf);
+        slot->ready = true;
+
+        ASSERT(buf.eof());
+    });
+    return value;
+}
+
+TraCICommandInterface::Batch::Value<std::string> TraCICommandInterface::Batch::getString(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId)
+{
+    return add<std::string>(commandId, objectId, variableId, responseId, TYPE_STRING, [](TraCIBuffer& buf) { return buf.read<std::string>(); });
+}
+
+TraCICommandInterface::Batch::Value<Coord> TraCICommandInterface::Batch::getCoord(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId)
+{
+    TraCIConnection* connection = &traci->connection;
+    return add<Coord>(commandId, objectId, variableId, responseId, POSITION_2D, [connection](TraCIBuffer& buf) {
+        double x = buf.read<double>();
+        double y = buf.read<double>();
+        return connection->traci2omnet(TraCICoord(x, y));
+    });
+}
+
+TraCICommandInterface::Batch::Value<double> TraCICommandInterface::Batch::getDouble(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId)
+{
+    return add<double>(commandId, objectId, variableId, responseId, TYPE_DOUBLE, [](TraCIBuffer& buf) { return buf.read<double>(); });
+}
+
+TraCICommandInterface::Batch::Value<int32_t> TraCICommandInterface::Batch::getInt(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId)
+{
+    return add<int32_t>(commandId, objectId, variableId, responseId, TYPE_INTEGER, [](TraCIBuffer& buf) { return buf.read<int32_t>(); });
+}
+
+TraCICommandInterface::Batch::Value<std::list<std::string>> TraCICommandInterface::Batch::getStringList(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId)
+{
+    return add<std::list<std::string>>(commandId, objectId, variableId, responseId, TYPE_STRINGLIST, [](TraCIBuffer& buf) {
+        std::list<std::string> res;
+        uint32_t count;
+        buf >> count;
+        for (uint32_t i = 0; i < count; i++) {
+            res.push_back(buf.read<std::string>());
+        }
+        return res;
+    });
+}
+
+TraCICommandInterface::Batch::Value<std::list<Coord>> TraCICommandInterface::Batch::getCoordList(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId)
+{
+    TraCIConnection* connection = &traci->connection;
+    return add<std::list<Coord>>(commandId, objectId, variableId, responseId, TYPE_POLYGON, [connection](TraCIBuffer& buf) {
+        std::list<Coord> res;
+        uint8_t count;
+        buf >> count;
+        for (uint32_t i = 0; i < count; i++) {
+            double x = buf.read<double>();
+            double y = buf.read<double>();
+            res.push_back(connection->traci2omnet(TraCICoord(x, y)));
+        }
+        return res;
+    });
+}
+
+void TraCICommandInterface::Batch::execute()
+{
+    std::vector<TraCIBuffer> responses = traci->connection.queryBatch(commands);
+    ASSERT(responses.size() == readResponses.size());
+    for (size_t i = 0; i < responses.size(); ++i) {
+        readResponses[i](responses[i]);
+    }
+    commands.clear();
+    readResponses.clear();
+}
+
+TraCICommandInterface::Batch::Value<std::string> TraCICommandInterface::Batch::Vehicle::getRoadId()
+{
+    return batch->getString(CMD_GET_VEHICLE_VARIABLE, nodeId, VAR_ROAD_ID, RESPONSE_GET_VEHICLE_VARIABLE);
+}
+
+TraCICommandInterface::Batch::Value<std::string> TraCICommandInterface::Batch::Vehicle::getLaneId()
+{
+    return batch->getString(CMD_GET_VEHICLE_VARIABLE, nodeId, VAR_LANE_ID, RESPONSE_GET_VEHICLE_VARIABLE);
+}
+
+TraCICommandInterface::Batch::Value<double> TraCICommandInterface::Batch::Vehicle::getLanePosition()
+{
+    return batch->getDouble(CMD_GET_VEHICLE_VARIABLE, nodeId, VAR_LANEPOSITION, RESPONSE_GET_VEHICLE_VARIABLE);
+}
+
+TraCICommandInterface::Batch::Value<std::string> TraCICommandInterface::Batch::Vehicle::getRouteId()
+{
+    return batch->getString(CMD_GET_VEHICLE_VARIABLE, nodeId, VAR_ROUTE_ID, RESPONSE_GET_VEHICLE_VARIABLE);
+}
+
+TraCICommandInterface::Batch::Value<std::list<std::string>> TraCICommandInterface::Batch::Vehicle::getPlannedRoadIds()
+{
+    return batch->getStringList(CMD_GET_VEHICLE_VARIABLE, nodeId, VAR_EDGES, RESPONSE_GET_VEHICLE_VARIABLE);
+}
+
+TraCICommandInterface::Batch::Value<double> TraCICommandInterface::Batch::Vehicle::getSpeed()
+{
+    return batch->getDouble(CMD_GET_VEHICLE_VARIABLE, nodeId, VAR_SPEED, RESPONSE_GET_VEHICLE_VARIABLE);
+}
+
+TraCICommandInterface::Batch::Value<Coord> TraCICommandInterface::Batch::Vehicle::getPosition()
+{
+    return batch->getCoord(CMD_GET_VEHICLE_VARIABLE, nodeId, VAR_POSITION, RESPONSE_GET_VEHICLE_VARIABLE);
+}
+
+TraCICommandInterface::Batch::Value<std::string> TraCICommandInterface::Batch::Polygon::getTypeId()
+{
+    return batch->getString(CMD_GET_POLYGON_VARIABLE, polyId, VAR_TYPE, RESPONSE_GET_POLYGON_VARIABLE);
+}
+
+TraCICommandInterface::Batch::Value<std::list<Coord>> TraCICommandInterface::Batch::Polygon::getShape()
+{
+    return batch->getCoordList(CMD_GET_POLYGON_VARIABLE, polyId, VAR_SHAPE, RESPONSE_GET_POLYGON_VARIABLE);
+}
+
 } // namespace veins
@@ -22,8 +22,11 @@
 
 #pragma once
 
+#include <functional>
 #include <list>
+#include <memory>
 #include <string>
+#include <vector>
 #include <stdint.h>
 
 #include "veins/modules/mobility/traci/TraCIColor.h"
@@ -510,6 +513,120 @@ public:
         return GuiView(this, viewId);
     }
 
+    /**
+     * Collects variable getters (for any number of objects) to send them to the TraCI server in a single message, saving a round trip per getter.
+     *
+     * Each getter returns a Value that can be read once execute() has returned.
+     * Unlike the getters of the command interface, getters in a batch only see the server's state when execute() is called.
+     */
+    class VEINS_API Batch {
+    public:
+        template <typename T>
+        class Value {
+        public:
+            bool isReady() const
+            {
+                return slot->ready;
+            }
+
+            const T& get() const
+            {
+                if (!slot->ready) throw cRuntimeError("TraCI batch has not been executed yet");
+                return slot->value;
+            }
+
+        private:
+            friend class Batch;
+            struct Slot {
+                T value = T();
+                bool ready = false;
+            };
+            std::shared_ptr<Slot> slot = std::make_shared<Slot>();
+        };
+
+        class VEINS_API Vehicle {
+        public:
+            Vehicle(Batch* batch, std::string nodeId)
+                : batch(batch)
+                , nodeId(nodeId)
+            {
+            }
+
+            Value<std::string> getRoadId();
+            Value<std::string> getLaneId();
+            Value<double> getLanePosition();
+            Value<std::string> getRouteId();
+            Value<std::list<std::string>> getPlannedRoadIds();
+            Value<double> getSpeed();
+            Value<Coord> getPosition();
+
+        protected:
+            Batch* batch;
+            std::string nodeId;
+        };
+        Vehicle vehicle(std::string nodeId)
+        {
+            return Vehicle(this, nodeId);
+        }
+
+        class VEINS_API Polygon {
+        public:
+            Polygon(Batch* batch, std::string polyId)
+                : batch(batch)
+                , polyId(polyId)
+            {
+            }
+
+            Value<std::string> getTypeId();
+            Value<std::list<Coord>> getShape();
+
+        protected:
+            Batch* batch;
+            std::string polyId;
+        };
+        Polygon polygon(std::string polyId)
+        {
+            return Polygon(this, polyId);
+        }
+
+        Batch(TraCICommandInterface* traci)
+            : traci(traci)
+        {
+        }
+
+        Value<std::string> getString(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId);
+        Value<Coord> getCoord(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId);
+        Value<double> getDouble(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId);
+        Value<int32_t> getInt(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId);
+        Value<std::list<std::string>> getStringList(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId);
+        Value<std::list<Coord>> getCoordList(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId);
+
+        /**
+         * number of getters not yet executed
+         */
+        size_t size() const
+        {
+            return commands.size();
+        }
+
+        /**
+         * send all collected getters to the TraCI server, resolve their values, and start over with an empty batch
+         */
+        void execute();
+
+    protected:
+        template <typename T>
+        Value<T> add(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId, uint8_t resultTypeId, std::function<T(TraCIBuffer&)> readValue);
+
+        TraCICommandInterface* traci;
+        std::vector<std::pair<uint8_t, TraCIBuffer>> commands;
+        std::vector<std::function<void(TraCIBuffer&)>> readResponses; /**< for each command, reads its response and resolves its value */
+    };
+    Batch batch()
+    {
+        return Batch(this);
+    }
+
 private:
     struct VersionConfig {
         unsigned version;
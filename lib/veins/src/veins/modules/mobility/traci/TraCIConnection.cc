@@ -28,10 +28,13 @@
 #include <netinet/tcp.h>
 #include <netdb.h>
 #include <arpa/inet.h>
+#include <sys/un.h>
+#define VEINS_HAVE_UNIX_SOCKETS
 #endif
 
 #include <algorithm>
 #include <functional>
+#include <sstream>
 
 #include "veins/modules/mobility/traci/TraCIConnection.h"
 #include "veins/modules/mobility/traci/TraCIConstants.h"
@@ -60,6 +63,74 @@ SOCKET socket(void* ptr)
     return *static_cast<SOCKET*>(ptr);
 }
 
+namespace {
+
+/**
+ * receive exactly length bytes into p
+ *
+ * Neither logs nor throws, so it is safe to call from a background thread.
+ *
+ * @return an error message, or an empty string on success
+ */
+std::string receiveBytes(SOCKET s, char* p, size_t length)
+{
+    size_t bytesRead = 0;
+    while (bytesRead < length) {
+        int receivedBytes = ::recv(s, p + bytesRead, length - bytesRead, 0);
+        if (receivedBytes > 0) {
+            bytesRead += receivedBytes;
+        }
+        else if (receivedBytes == 0) {
+            return "Connection to TraCI server closed unexpectedly. Check your server's log";
+        }
+        else {
+            if (sock_errno() == EINTR) continue;
+            if (sock_errno() == EAGAIN) continue;
+            std::stringstream ss;
+            ss << "Connection to TraCI server lost. Check your server's log. Error message: " << sock_errno() << ": " << strerror(sock_errno());
+            return ss.str();
+        }
+    }
+    return "";
+}
+
+/**
+ * receive a TraCI message into buf (stripping the header)
+ *
+ * @return an error message, or an empty string on success
+ */
+std::string receiveMessageFrom(SOCKET s, TraCIBuffer& buf)
+{
+    uint32_t msgLength;
+    std::string error = receiveBytes(s, buf.prepare(sizeof(uint32_t)), sizeof(uint32_t));
+    if (!error.empty()) return error;
+    buf >> msgLength;
+
+    uint32_t bufLength = msgLength - sizeof(msgLength);
+    return receiveBytes(s, buf.prepare(bufLength), bufLength);
+}
+
+/**
+ * returns the length (in bytes) of the TraCI command at the start of data, and stores its ID in commandId
+ */
+size_t peekCommand(const char* data, size_t size, uint8_t& commandId)
+{
+    if (size < 2) throw cRuntimeError("Truncated command in TraCI message");
+    size_t length = static_cast<uint8_t>(data[0]);
+    commandId = static_cast<uint8_t>(data[1]);
+    if (length == 0) {
+        // extended length field
+        if (size < 6) throw cRuntimeError("Truncated command in TraCI message");
+        length = 0;
+        for (int i = 1; i <= 4; ++i) length = (length << 8) | static_cast<uint8_t>(data[i]);
+        commandId = static_cast<uint8_t>(data[5]);
+    }
+    if (length < 2 || length > size) throw cRuntimeError("Truncated command in TraCI message");
+    return length;
+}
+
+} // anonymous namespace
+
 TraCIConnection::Result::Result()
     : success(false)
     , not_impl(false)
@@ -77,12 +148,25 @@ TraCIConnection::Result::Result(bool success, bool not_impl, std::string message
 TraCIConnection::TraCIConnection(cComponent* owner, void* ptr)
     : HasLogProxy(owner)
     , socketPtr(ptr)
+    , pendingCommandId(0)
+    , hasPendingResponse(false)
 {
     ASSERT(socketPtr);
 }
 
 TraCIConnection::~TraCIConnection()
 {
+    // the background thread must not outlive the socket; shutting the socket down makes it return even if the server never answers (e.g., when the run aborted)
+    if (pendingReceive.valid()) {
+        if (socketPtr) {
+#if defined(_WIN32) || defined(__WIN32__) || defined(WIN32) || defined(__CYGWIN__) || defined(_WIN64)
+            shutdown(socket(socketPtr), SD_BOTH);
+#else
+            shutdown(socket(socketPtr), SHUT_RDWR);
+#endif
+        }
+        pendingReceive.wait();
+    }
     if (socketPtr) {
         closesocket(socket(socketPtr));
         delete static_cast<SOCKET*>(socketPtr);
@@ -96,35 +180,58 @@ TraCIConnection* TraCIConnection::connect(cComponent* owner, const char* host, i
 
     if (initsocketlibonce() != 0) throw cRuntimeError("Could not init socketlib");
 
-    in_addr addr;
-    struct hostent* host_ent;
-    struct in_addr saddr;
+    sockaddr_in address;
+    sockaddr* address_p = (sockaddr*) &address;
+    socklen_t addressLength = sizeof(address);
+    memset(address_p, 0, sizeof(address));
 
-    saddr.s_addr = inet_addr(host);
-    if (saddr.s_addr != static_cast<unsigned int>(-1)) {
-        addr = saddr;
-    }
-    else if ((host_ent = gethostbyname(host))) {
-        addr = *((struct in_addr*) host_ent->h_addr_list[0]);
+#ifdef VEINS_HAVE_UNIX_SOCKETS
+    sockaddr_un unixAddress;
+#endif
+    const std::string unixPrefix = "unix:";
+    const bool useUnixSocket = std::string(host).compare(0, unixPrefix.size(), unixPrefix) == 0;
+
+    if (useUnixSocket) {
+#ifdef VEINS_HAVE_UNIX_SOCKETS
+        std::string path = host + unixPrefix.size();
+        if (path.empty() || path.size() >= sizeof(unixAddress.sun_path)) throw cRuntimeError("Invalid TraCI server socket path: %s", path.c_str());
+        address_p = (sockaddr*) &unixAddress;
+        addressLength = sizeof(unixAddress);
+        memset(address_p, 0, sizeof(unixAddress));
+        unixAddress.sun_family = AF_UNIX;
+        strncpy(unixAddress.sun_path, path.c_str(), sizeof(unixAddress.sun_path) - 1);
+#else
+        throw cRuntimeError("Connecting to TraCI server via a Unix domain socket (%s) is not supported on this platform", host);
+#endif
     }
     else {
-        throw cRuntimeError("Invalid TraCI server address: %s", host);
-        return nullptr;
-    }
+        in_addr addr;
+        struct hostent* host_ent;
+        struct in_addr saddr;
 
-    sockaddr_in address;
-    sockaddr* address_p = (sockaddr*) &address;
-    memset(address_p, 0, sizeof(address));
-    address.sin_family = AF_INET;
-    address.sin_port = htons(port);
-    address.sin_addr.s_addr = addr.s_addr;
+        saddr.s_addr = inet_addr(host);
+        if (saddr.s_addr != static_cast<unsigned int>(-1)) {
+            addr = saddr;
+        }
+        else if ((host_ent = gethostbyname(host))) {
+            addr = *((struct in_addr*) host_ent->h_addr_list[0]);
+        }
+        else {
+            throw cRuntimeError("Invalid TraCI server address: %s", host);
+            return nullptr;
+        }
+
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = addr.s_addr;
+    }
 
     SOCKET* socketPtr = new SOCKET();
     if (*socketPtr < 0) throw cRuntimeError("Could not create socket to connect to TraCI server");
 
     for (int tries = 1; tries <= 10; ++tries) {
-        *socketPtr = ::socket(AF_INET, SOCK_STREAM, 0);
-        if (::connect(*socketPtr, address_p, sizeof(address)) >= 0) break;
+        *socketPtr = ::socket(address_p->sa_family, SOCK_STREAM, 0);
+        if (::connect(*socketPtr, address_p, addressLength) >= 0) break;
         closesocket(socket(socketPtr));
 
         std::stringstream ss;
@@ -143,7 +250,7 @@ TraCIConnection* TraCIConnection::connect(cComponent* owner, const char* host, i
         sleep(sleepDuration);
     }
 
-    {
+    if (!useUnixSocket) {
         int x = 1;
         ::setsockopt(*socketPtr, IPPROTO_TCP, TCP_NODELAY, (const char*) &x, sizeof(x));
     }
@@ -153,9 +260,55 @@ TraCIConnection* TraCIConnection::connect(cComponent* owner, const char* host, i
 
 TraCIBuffer TraCIConnection::query(uint8_t commandId, const TraCIBuffer& buf, Result* result)
 {
+    waitForPendingQuery();
+    sendMessage(makeTraCICommand(commandId, buf));
+    return checkResponse(commandId, receiveMessage(), result);
+}
+
+void TraCIConnection::startQuery(uint8_t commandId, const TraCIBuffer& buf)
+{
+    if (!socketPtr) throw cRuntimeError("Not connected to TraCI server");
+    if (hasPendingQuery()) throw cRuntimeError("Cannot start a TraCI query while the response to another one is still pending");
+
     sendMessage(makeTraCICommand(commandId, buf));
+    pendingCommandId = commandId;
+    SOCKET s = socket(socketPtr);
+    pendingReceive = std::async(std::launch::async, [s]() {
+        std::pair<TraCIBuffer, std::string> response;
+        response.second = receiveMessageFrom(s, response.first);
+        return response;
+    });
+}
+
+TraCIBuffer TraCIConnection::finishQuery(Result* result)
+{
+    if (!hasPendingQuery()) throw cRuntimeError("No TraCI query was started");
+
+    waitForPendingQuery();
+    hasPendingResponse = false;
+    TraCIBuffer obuf;
+    std::swap(obuf, pendingResponse);
+    return checkResponse(pendingCommandId, std::move(obuf), result);
+}
+
+bool TraCIConnection::hasPendingQuery() const
+{
+    return pendingReceive.valid() || hasPendingResponse;
+}
 
-    TraCIBuffer obuf(receiveMessage());
+void TraCIConnection::waitForPendingQuery()
+{
+    if (!pendingReceive.valid()) return;
+
+    std::pair<TraCIBuffer, std::string> response = pendingReceive.get();
+    if (!response.second.empty()) throw cRuntimeError("%s", response.second.c_str());
+    EV_TRACE << "Read TraCI message of " << response.first.size() << " bytes (in background)" << endl;
+    pendingResponse = std::move(response.first);
+    hasPendingResponse = true;
+}
+
+TraCIBuffer TraCIConnection::checkResponse(uint8_t commandId, TraCIBuffer obuf, Result* result)
+{
     uint8_t cmdLength;
     obuf >> cmdLength;
     uint8_t commandResp;
@@ -177,52 +330,48 @@ TraCIBuffer TraCIConnection::query(uint8_t commandId, const TraCIBuffer& buf, Re
     return obuf;
 }
 
-std::string TraCIConnection::receiveMessage()
+std::vector<TraCIBuffer> TraCIConnection::queryBatch(const std::vector<std::pair<uint8_t, TraCIBuffer>>& commands)
 {
-    if (!socketPtr) throw cRuntimeError("Not connected to TraCI server");
+    std::vector<TraCIBuffer> responses;
+    if (commands.empty()) return responses;
 
-    uint32_t msgLength;
-    {
-        char buf2[sizeof(uint32_t)];
-        uint32_t bytesRead = 0;
-        while (bytesRead < sizeof(uint32_t)) {
-            int receivedBytes = ::recv(socket(socketPtr), reinterpret_cast<char*>(&buf2) + bytesRead, sizeof(uint32_t) - bytesRead, 0);
-            if (receivedBytes > 0) {
-                bytesRead += receivedBytes;
-            }
-            else if (receivedBytes == 0) {
-                throw cRuntimeError("Connection to TraCI server closed unexpectedly. Check your server's log");
-            }
-            else {
-                if (sock_errno() == EINTR) continue;
-                if (sock_errno() == EAGAIN) continue;
-                throw cRuntimeError("Connection to TraCI server lost. Check your server's log. Error message: %d: %s", sock_errno(), strerror(sock_errno()));
-            }
-        }
-        TraCIBuffer(std::string(buf2, sizeof(uint32_t))) >> msgLength;
+    waitForPendingQuery();
+    std::string message;
+    for (const auto& command : commands) {
+        message += makeTraCICommand(command.first, command.second);
     }
-
-    uint32_t bufLength = msgLength - sizeof(msgLength);
-    char buf[bufLength];
-    {
-        EV_TRACE << "Reading TraCI message of " << bufLength << " bytes" << endl;
-        uint32_t bytesRead = 0;
-        while (bytesRead < bufLength) {
-            int receivedBytes = ::recv(socket(socketPtr), reinterpret_cast<char*>(&buf) + bytesRead, bufLength - bytesRead, 0);
-            if (receivedBytes > 0) {
-                bytesRead += receivedBytes;
-            }
-            else if (receivedBytes == 0) {
-                throw cRuntimeError("Connection to TraCI server closed unexpectedly. Check your server's log");
-            }
-            else {
-                if (sock_errno() == EINTR) continue;
-                if (sock_errno() == EAGAIN) continue;
-                throw cRuntimeError("Connection to TraCI server lost. Check your server's log. Error message: %d: %s", sock_errno(), strerror(sock_errno()));
-            }
+    sendMessage(message);
+
+    // for each command, the response holds a status response, followed by any number of additional responses (whose IDs differ from the IDs of commands)
+    TraCIBuffer obuf = receiveMessage();
+    responses.reserve(commands.size());
+    size_t pos = 0;
+    for (size_t i = 0; i < commands.size(); ++i) {
+        const size_t begin = pos;
+        uint8_t commandId;
+        pos += peekCommand(obuf.data() + pos, obuf.size() - pos, commandId);
+        while (pos < obuf.size()) {
+            size_t length = peekCommand(obuf.data() + pos, obuf.size() - pos, commandId);
+            if ((i + 1 < commands.size()) && (commandId == commands[i + 1].first)) break;
+            pos += length;
         }
+        TraCIBuffer response;
+        std::copy(obuf.data() + begin, obuf.data() + pos, response.prepare(pos - begin));
+        responses.push_back(checkResponse(commands[i].first, std::move(response), nullptr));
     }
-    return std::string(buf, bufLength);
+    return responses;
+}
+
+TraCIBuffer TraCIConnection::receiveMessage()
+{
+    if (!socketPtr) throw cRuntimeError("Not connected to TraCI server");
+    ASSERT(!pendingReceive.valid());
+
+    TraCIBuffer buf;
+    std::string error = receiveMessageFrom(socket(socketPtr), buf);
+    if (!error.empty()) throw cRuntimeError("%s", error.c_str());
+    EV_TRACE << "Read TraCI message of " << buf.size() << " bytes" << endl;
+    return buf;
 }
 
 void TraCIConnection::sendMessage(std::string buf)
@@ -235,7 +384,7 @@ void TraCIConnection::sendMessage(std::string buf)
         buf2 << msgLength;
         uint32_t bytesWritten = 0;
         while (bytesWritten < sizeof(uint32_t)) {
-            ssize_t sentBytes = ::send(socket(socketPtr), buf2.str().c_str() + bytesWritten, sizeof(uint32_t) - bytesWritten, 0);
+            ssize_t sentBytes = ::send(socket(socketPtr), buf2.data() + bytesWritten, sizeof(uint32_t) - bytesWritten, 0);
             if (sentBytes > 0) {
                 bytesWritten += sentBytes;
             }
@@ -266,12 +415,17 @@ void TraCIConnection::sendMessage(std::string buf)
 
 std::string makeTraCICommand(uint8_t commandId, const TraCIBuffer& buf)
 {
-    if (sizeof(uint8_t) + sizeof(uint8_t) + buf.str().length() > 0xFF) {
-        uint32_t len = sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint8_t) + buf.str().length();
-        return (TraCIBuffer() << static_cast<uint8_t>(0) << len << commandId).str() + buf.str();
+    std::string command;
+    if (sizeof(uint8_t) + sizeof(uint8_t) + buf.size() > 0xFF) {
+        uint32_t len = sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint8_t) + buf.size();
+        command = (TraCIBuffer() << static_cast<uint8_t>(0) << len << commandId).str();
+    }
+    else {
+        uint8_t len = sizeof(uint8_t) + sizeof(uint8_t) + buf.size();
+        command = (TraCIBuffer() << len << commandId).str();
     }
-    uint8_t len = sizeof(uint8_t) + sizeof(uint8_t) + buf.str().length();
-    return (TraCIBuffer() << len << commandId).str() + buf.str();
+    command.append(buf.data(), buf.size());
+    return command;
 }
 
 void TraCIConnection::setNetbounds(TraCICoord netbounds1, TraCICoord netbounds2, int margin)
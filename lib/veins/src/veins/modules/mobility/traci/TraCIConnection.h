@@ -23,7 +23,10 @@
 #pragma once
 
 #include <stdint.h>
+#include <future>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "veins/modules/mobility/traci/TraCIBuffer.h"
 #include "veins/modules/mobility/traci/TraCICoord.h"
@@ -46,6 +49,9 @@ public:
         std::string message;
     };
 
+    /**
+     * connects to a TraCI server via TCP, or via a Unix domain socket if host is given as "unix:<path>" (then, port is ignored)
+     */
     static TraCIConnection* connect(cComponent* owner, const char* host, int port);
     void setNetbounds(TraCICoord netbounds1, TraCICoord netbounds2, int margin);
     ~TraCIConnection();
@@ -58,6 +64,25 @@ public:
      */
     TraCIBuffer query(uint8_t commandId, const TraCIBuffer& buf = TraCIBuffer(), Result* result = nullptr);
 
+    /**
+     * sends a single command via TraCI, but receives the response on a background thread.
+     * Only one such query can be pending at any time.
+     * Any other query first waits for the response (and keeps it for finishQuery()), so commands stay in order.
+     */
+    void startQuery(uint8_t commandId, const TraCIBuffer& buf = TraCIBuffer());
+
+    /**
+     * waits for the response to the command sent by startQuery(), then handles it like query()
+     */
+    TraCIBuffer finishQuery(Result* result = nullptr);
+
+    bool hasPendingQuery() const;
+
+    /**
+     * sends several commands via TraCI in a single message, checks their status responses, returns additional responses (one buffer per command).
+     */
+    std::vector<TraCIBuffer> queryBatch(const std::vector<std::pair<uint8_t, TraCIBuffer>>& commands);
+
     /**
      * sends a message via TraCI (after adding the header)
      */
@@ -66,7 +91,7 @@ public:
     /**
      * receives a message via TraCI (and strips the header)
      */
-    std::string receiveMessage();
+    TraCIBuffer receiveMessage();
 
     /**
      * convert TraCI heading to OMNeT++ heading (in rad)
@@ -93,7 +118,21 @@ public:
 private:
     TraCIConnection(cComponent* owner, void* ptr);
 
+    /**
+     * receives the response to a command sent by startQuery() (if it has not been received yet)
+     */
+    void waitForPendingQuery();
+
+    /**
+     * checks the status response to a command, returns additional responses
+     */
+    TraCIBuffer checkResponse(uint8_t commandId, TraCIBuffer obuf, Result* result);
+
     void* socketPtr;
+    uint8_t pendingCommandId; /**< command sent by startQuery() */
+    std::future<std::pair<TraCIBuffer, std::string>> pendingReceive; /**< response (or error message) being received in the background */
+    bool hasPendingResponse; /**< whether pendingResponse holds the (already received) response to pendingCommandId */
+    TraCIBuffer pendingResponse;
     std::unique_ptr<TraCICoordinateTransformation> coordinateTransformation;
 };
 
@@ -20,6 +20,7 @@
 // Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 //
 
+#include <cstring>
 #include <limits>
 #include <iostream>
 #include <sstream>
@@ -182,7 +183,9 @@ void TraCIMobility::nextPosition(const Coord& position, std::string road_id, dou
     this->heading = heading;
     this->signals = signals;
 
+    const Coord extrapolatedPos = move.getPositionAt(simTime());
     changePosition();
+    lastPositionDeviation = extrapolatedPos.distance(move.getStartPos());
     ASSERT(getCurrentDirection() == heading.toCoord() and getCurrentDirection() == getCurrentOrientation());
 }
 
@@ -226,12 +229,14 @@ void TraCIMobility::changePosition()
     this->lastUpdate = simTime();
 
     // Update display string to show node is getting updates
-    auto hostMod = getParentModule();
-    if (std::string(hostMod->getDisplayString().getTagArg("veins", 0)) == ". ") {
-        hostMod->getDisplayString().setTagArg("veins", 0, " .");
-    }
-    else {
-        hostMod->getDisplayString().setTagArg("veins", 0, ". ");
+    if (!headless && hasGUI()) {
+        cDisplayString& displayString = getParentModule()->getDisplayString();
+        if (std::strcmp(displayString.getTagArg("veins", 0), ". ") == 0) {
+            displayString.setTagArg("veins", 0, " .");
+        }
+        else {
+            displayString.setTagArg("veins", 0, ". ");
+        }
     }
 
     move.setStart(Coord(nextPos.x, nextPos.y, move.getStartPosition().z)); // keep z position
@@ -160,6 +160,22 @@ public:
         return BaseMobility::getCurrentSpeed();
     }
 
+    /**
+     * Returns whether the speed of the host is updated along with its position (i.e., whether its position can be extrapolated in between updates)
+     */
+    bool setsHostSpeed() const
+    {
+        return setHostSpeed;
+    }
+
+    /**
+     * Returns how far the position received by the last call to nextPosition() was from the position linearly extrapolated from the previous update
+     */
+    double getLastPositionDeviation() const
+    {
+        return lastPositionDeviation;
+    }
+
 protected:
     int accidentCount; /**< number of accidents */
 
@@ -183,6 +199,7 @@ protected:
     double speed; /**< updated by nextPosition() */
     Heading heading; /**< updated by nextPosition() */
     VehicleSignalSet signals; /**<updated by nextPosition() */
+    double lastPositionDeviation = 0; /**< updated by nextPosition() */
 
     cMessage* startAccidentMsg = nullptr;
     cMessage* stopAccidentMsg = nullptr;
@@ -0,0 +1,224 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "veins/modules/mobility/traci/TraCIPolygonCache.h"
+
+using veins::TraCICoord;
+using veins::TraCIPolygonCache;
+
+struct TraCIPolygonCache::Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t numPolygons;
+    uint64_t sourceFingerprint;
+    double networkBoundaries[4];
+    double margin;
+};
+
+namespace {
+
+const char fileMagic[8] = {'V', 'E', 'I', 'N', 'S', 'P', 'L', 'C'};
+const uint32_t fileVersion = 1;
+const uint64_t fnvOffsetBasis = 14695981039346656037ULL;
+const uint64_t fnvPrime = 1099511628211ULL;
+
+void fnv1a(uint64_t& hash, const char* data, size_t size)
+{
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= fnvPrime;
+    }
+}
+
+template <typename T>
+void writeValue(std::ofstream& out, const T& value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void writeString(std::ofstream& out, const std::string& value)
+{
+    writeValue(out, static_cast<uint32_t>(value.size()));
+    out.write(value.data(), value.size());
+}
+
+/**
+ * reads values from a file's contents, failing (instead of reading past the end) on truncated data
+ */
+class Reader {
+public:
+    Reader(const std::vector<char>& data)
+        : data(data)
+    {
+    }
+
+    template <typename T>
+    bool read(T& value)
+    {
+        if (data.size() - pos < sizeof(T)) return false;
+        std::memcpy(&value, data.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+
+    bool read(std::string& value)
+    {
+        uint32_t size;
+        if (!read(size) || data.size() - pos < size) return false;
+        value.assign(data.data() + pos, size);
+        pos += size;
+        return true;
+    }
+
+    bool atEnd() const
+    {
+        return pos == data.size();
+    }
+
+private:
+    const std::vector<char>& data;
+    size_t pos = 0;
+};
+
+void toArray(const std::pair<TraCICoord, TraCICoord>& networkBoundaries, double (&array)[4])
+{
+    array[0] = networkBoundaries.first.x;
+    array[1] = networkBoundaries.first.y;
+    array[2] = networkBoundaries.second.x;
+    array[3] = networkBoundaries.second.y;
+}
+
+} // anonymous namespace
+
+TraCIPolygonCache::TraCIPolygonCache(std::string fileName, std::vector<std::string> sourceFileNames)
+    : fileName(std::move(fileName))
+    , sourceFileNames(std::move(sourceFileNames))
+{
+}
+
+bool TraCIPolygonCache::fingerprintSources()
+{
+    uint64_t hash = fnvOffsetBasis;
+    std::vector<char> chunk(1 << 16);
+    for (const auto& sourceFileName : sourceFileNames) {
+        std::ifstream in(sourceFileName, std::ios::binary);
+        if (!in) return false;
+        fnv1a(hash, sourceFileName.c_str(), sourceFileName.size() + 1);
+        while (in) {
+            in.read(chunk.data(), chunk.size());
+            fnv1a(hash, chunk.data(), in.gcount());
+        }
+    }
+    sourceFingerprint = hash;
+    return true;
+}
+
+bool TraCIPolygonCache::load()
+{
+    loaded = false;
+    polygons.clear();
+    sourcesRead = fingerprintSources();
+    if (!sourcesRead) return false;
+
+    std::ifstream in(fileName, std::ios::binary);
+    if (!in) return false;
+    const std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    Reader reader(data);
+
+    Header header;
+    bool valid = reader.read(header);
+    valid = valid && (std::memcmp(header.magic, fileMagic, sizeof(header.magic)) == 0);
+    valid = valid && (header.version == fileVersion);
+    valid = valid && (header.sourceFingerprint == sourceFingerprint);
+    if (!valid) return false;
+
+    std::vector<Polygon> read(header.numPolygons);
+    for (auto& polygon : read) {
+        uint8_t hasShape;
+        uint32_t numPoints;
+        valid = reader.read(polygon.id) && reader.read(polygon.typeId) && reader.read(hasShape) && reader.read(numPoints);
+        if (!valid || numPoints > data.size() / sizeof(Coord)) return false;
+        polygon.hasShape = (hasShape != 0);
+        polygon.shape.resize(numPoints);
+        for (auto& point : polygon.shape) {
+            valid = valid && reader.read(point.x) && reader.read(point.y) && reader.read(point.z);
+        }
+        if (!valid) return false;
+    }
+    if (!reader.atEnd()) return false;
+
+    std::memcpy(networkBoundaries, header.networkBoundaries, sizeof(networkBoundaries));
+    margin = header.margin;
+    polygons.swap(read);
+    loaded = true;
+    return true;
+}
+
+bool TraCIPolygonCache::isValidFor(const std::pair<TraCICoord, TraCICoord>& networkBoundaries, double margin) const
+{
+    double boundaries[4];
+    toArray(networkBoundaries, boundaries);
+    return loaded && std::equal(boundaries, boundaries + 4, this->networkBoundaries) && (margin == this->margin);
+}
+
+void TraCIPolygonCache::store(const std::pair<TraCICoord, TraCICoord>& networkBoundaries, double margin, std::vector<Polygon> polygons)
+{
+    if (!sourcesRead) {
+        throw cRuntimeError("Could not read all source files of polygon cache \"%s\"", fileName.c_str());
+    }
+    toArray(networkBoundaries, this->networkBoundaries);
+    this->margin = margin;
+    this->polygons = std::move(polygons);
+    loaded = true;
+
+    std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw cRuntimeError("Could not open polygon cache \"%s\" for writing", fileName.c_str());
+    }
+    Header header;
+    std::memcpy(header.magic, fileMagic, sizeof(header.magic));
+    header.version = fileVersion;
+    header.numPolygons = static_cast<uint32_t>(this->polygons.size());
+    header.sourceFingerprint = sourceFingerprint;
+    std::memcpy(header.networkBoundaries, this->networkBoundaries, sizeof(header.networkBoundaries));
+    header.margin = margin;
+    writeValue(out, header);
+    for (const auto& polygon : this->polygons) {
+        writeString(out, polygon.id);
+        writeString(out, polygon.typeId);
+        writeValue(out, static_cast<uint8_t>(polygon.hasShape));
+        writeValue(out, static_cast<uint32_t>(polygon.shape.size()));
+        for (const auto& point : polygon.shape) {
+            writeValue(out, point.x);
+            writeValue(out, point.y);
+            writeValue(out, point.z);
+        }
+    }
+    if (!out) {
+        throw cRuntimeError("Could not write polygon cache \"%s\"", fileName.c_str());
+    }
+}
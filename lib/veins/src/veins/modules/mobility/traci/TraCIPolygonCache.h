@@ -0,0 +1,94 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "veins/veins.h"
+
+#include "veins/base/utils/Coord.h"
+#include "veins/modules/mobility/traci/TraCICoord.h"
+
+namespace veins {
+
+/**
+ * File cache of the polygons a TraCIScenarioManager fetches from the TraCI server at startup (to create radio obstacles).
+ *
+ * The cache is keyed by a fingerprint of the contents of its source files (e.g., the SUMO net and poly files),
+ * so it can be loaded while the TraCI server is still starting up.
+ * Once connected, the network boundaries and margin (which determine the coordinate transformation) have to match, too.
+ */
+class VEINS_API TraCIPolygonCache {
+public:
+    struct Polygon {
+        std::string id;
+        std::string typeId;
+        bool hasShape = false; /**< shapes are only fetched (and stored) for polygons of a type the simulation uses */
+        std::vector<Coord> shape; /**< in OMNeT++ coordinates */
+    };
+
+    TraCIPolygonCache(std::string fileName, std::vector<std::string> sourceFileNames);
+
+    /**
+     * fingerprint the source files and read the cache file.
+     *
+     * Neither logs nor throws, so it can run on a background thread.
+     *
+     * @return false if a source file cannot be read or the cache file does not exist, is malformed, or is stale
+     */
+    bool load();
+
+    /**
+     * whether polygons have been loaded that were fetched with the given network boundaries and margin
+     */
+    bool isValidFor(const std::pair<TraCICoord, TraCICoord>& networkBoundaries, double margin) const;
+
+    const std::vector<Polygon>& getPolygons() const
+    {
+        return polygons;
+    }
+
+    /**
+     * replace the cached polygons and write them to the cache file, overwriting any existing file
+     */
+    void store(const std::pair<TraCICoord, TraCICoord>& networkBoundaries, double margin, std::vector<Polygon> polygons);
+
+private:
+    struct Header;
+
+    bool fingerprintSources();
+
+    std::string fileName;
+    std::vector<std::string> sourceFileNames;
+    bool sourcesRead = false; /**< whether all source files could be read (and sourceFingerprint is valid) */
+    uint64_t sourceFingerprint = 0;
+    bool loaded = false;
+    double networkBoundaries[4] = {0, 0, 0, 0}; /**< x1, y1, x2, y2 of the loaded polygons' network boundaries */
+    double margin = 0;
+    std::vector<Polygon> polygons;
+};
+
+} // namespace veins
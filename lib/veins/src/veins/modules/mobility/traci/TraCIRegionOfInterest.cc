@@ -105,9 +105,30 @@ bool TraCIRegionOfInterest::hasConstraints() const
     return !roiRoads.empty() || !roiRects.empty();
 }
 
+bool TraCIRegionOfInterest::hasRoads() const
+{
+    return !roiRoads.empty();
+}
+
 const std::list<std::pair<TraCICoord, TraCICoord>>& TraCIRegionOfInterest::getRectangles() const
 {
     return roiRects;
 }
 
+std::pair<TraCICoord, TraCICoord> TraCIRegionOfInterest::getRectanglesBoundingBox() const
+{
+    ASSERT(!roiRects.empty());
+    TraCICoord p1(roiRects.front().first);
+    TraCICoord p2(roiRects.front().first);
+    for (const auto& rect : roiRects) {
+        for (const TraCICoord& corner : {rect.first, rect.second}) {
+            p1.x = std::min(p1.x, corner.x);
+            p1.y = std::min(p1.y, corner.y);
+            p2.x = std::max(p2.x, corner.x);
+            p2.y = std::max(p2.y, corner.y);
+        }
+    }
+    return std::make_pair(p1, p2);
+}
+
 } // namespace veins
@@ -82,8 +82,20 @@ public:
      */
     bool hasConstraints() const;
 
+    /**
+     * Check if any roads are part of the constraints
+     * @return true if ROI roads exist
+     */
+    bool hasRoads() const;
+
     const std::list<std::pair<TraCICoord, TraCICoord>>& getRectangles() const;
 
+    /**
+     * Smallest rectangle containing all ROI rectangles
+     * @return lower left and upper right corner (only valid if rectangles exist)
+     */
+    std::pair<TraCICoord, TraCICoord> getRectanglesBoundingBox() const;
+
 private:
     std::set<std::string> roiRoads; /**< which roads (e.g. "hwy1 hwy2") are considered to consitute the region of interest, if not empty */
     std::list<std::pair<TraCICoord, TraCICoord>> roiRects; /**< which rectangles (e.g. "0,0-10,10 20,20-30,30) are considered to consitute the region of interest, if not empty */
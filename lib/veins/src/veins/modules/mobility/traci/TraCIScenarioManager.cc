@@ -26,6 +26,8 @@
 #include <stdexcept>
 #include <iterator>
 #include <cstdlib>
+#include <cmath>
+#include <unordered_set>
 
 #include "veins/modules/mobility/traci/TraCIScenarioManager.h"
 #include "veins/base/connectionManager/ChannelAccess.h"
@@ -34,12 +36,15 @@
 #include "veins/modules/mobility/traci/TraCIMobility.h"
 #include "veins/modules/obstacle/ObstacleControl.h"
 #include "veins/modules/world/traci/trafficLight/TraCITrafficLightInterface.h"
+#include "veins/modules/utility/Profiler.h"
 
 using namespace veins::TraCIConstants;
 
 using veins::AnnotationManagerAccess;
+using veins::Coord;
 using veins::TraCIBuffer;
 using veins::TraCICoord;
+using veins::TraCIPolygonCache;
 using veins::TraCIScenarioManager;
 using veins::TraCITrafficLightInterface;
 
@@ -78,6 +83,9 @@ TraCIScenarioManager::~TraCIScenarioManager()
 
 namespace {
 
+const std::string roiPoiId = "veins.roi"; /**< POI whose context is subscribed to with roiSubscriptionFilter */
+const double roiPoiRangeMargin = 1; /**< extra range of the POI context subscription, so vehicles at the corners of the ROI are reported */
+
 std::vector<std::string> getMapping(std::string el)
 {
 
@@ -254,7 +262,16 @@ void TraCIScenarioManager::initialize(int stage)
     firstStepAt = par("firstStepAt");
     updateInterval = par("updateInterval");
     if (firstStepAt == -1) firstStepAt = connectAt + updateInterval;
+    maxUpdateInterval = par("maxUpdateInterval");
+    maxPositionDeviation = par("maxPositionDeviation");
+    if (maxUpdateInterval > updateInterval && maxUpdateInterval.raw() % updateInterval.raw() != 0) {
+        throw cRuntimeError("maxUpdateInterval has to be a multiple of updateInterval");
+    }
+    currentUpdateInterval = updateInterval;
+    stepPositionDeviation = 0;
     parseModuleTypes();
+    vehicleModuleTemplates.clear();
+    moduleTypeCache.clear();
     penetrationRate = par("penetrationRate").doubleValue();
     ignoreGuiCommands = par("ignoreGuiCommands");
     host = par("host").stdstringValue();
@@ -263,16 +280,42 @@ void TraCIScenarioManager::initialize(int stage)
         throw cRuntimeError("TraCI Port autoconfiguration failed, set 'port' != -1 in omnetpp.ini or provide VEINS_TRACI_PORT environment variable.");
     }
     autoShutdown = par("autoShutdown");
+    useContextSubscription = par("useContextSubscription");
+    lookahead = par("lookahead");
+
+    polygonCache.reset();
+    const std::string polygonCacheFile = par("polygonCacheFile").stdstringValue();
+    if (!polygonCacheFile.empty()) {
+        std::istringstream sourcesStream(par("polygonCacheSources").stdstringValue());
+        std::vector<std::string> sources((std::istream_iterator<std::string>(sourcesStream)), std::istream_iterator<std::string>());
+        if (sources.empty()) {
+            throw cRuntimeError("polygonCacheFile is set, but polygonCacheSources is empty: a polygon cache needs source files to detect when it is stale");
+        }
+        polygonCache.reset(new TraCIPolygonCache(polygonCacheFile, sources));
+        // hashing the sources and reading the cache only touches files, so it can overlap with the TraCI server starting up
+        TraCIPolygonCache* cache = polygonCache.get();
+        polygonCacheLoaded = std::async(std::launch::async, [cache]() { return cache->load(); });
+    }
 
     annotations = AnnotationManagerAccess().getIfExists();
 
     roi.clear();
     roi.addRoads(par("roiRoads"));
     roi.addRectangles(par("roiRects"));
+    roiSubscriptionFilter = par("roiSubscriptionFilter");
+    if (roiSubscriptionFilter) {
+        if (!useContextSubscription) throw cRuntimeError("roiSubscriptionFilter requires useContextSubscription");
+        if (roi.hasRoads()) throw cRuntimeError("roiSubscriptionFilter does not support roiRoads");
+        if (roi.getRectangles().empty()) throw cRuntimeError("roiSubscriptionFilter requires roiRects");
+    }
 
     areaSum = 0;
     nextNodeVectorIndex = 0;
-    hosts.clear();
+    managedHosts.clear();
+    freeHostHandles.clear();
+    hostHandles.clear();
+    managedModuleCount = 0;
+    unequippedHostCount = 0;
     subscribedVehicles.clear();
     trafficLights.clear();
     activeVehicleCount = 0;
@@ -302,9 +345,10 @@ void TraCIScenarioManager::init_traci()
         commandInterface->setApiVersion(apiVersion.first);
     }
 
+    std::pair<TraCICoord, TraCICoord> networkBoundaries;
     {
         // query and set road network boundaries
-        auto networkBoundaries = commandInterface->initNetworkBoundaries(par("margin"));
+        networkBoundaries = commandInterface->initNetworkBoundaries(par("margin"));
         if (world != nullptr && ((connection->traci2omnet(networkBoundaries.second).x > world->getPgs()->x) || (connection->traci2omnet(networkBoundaries.first).y > world->getPgs()->y))) {
             EV_WARN << "WARNING: Playground size (" << world->getPgs()->x << ", " << world->getPgs()->y << ") might be too small for vehicle at network bounds (" << connection->traci2omnet(networkBoundaries.second).x << ", " << connection->traci2omnet(networkBoundaries.first).y << ")" << endl;
         }
@@ -328,7 +372,10 @@ void TraCIScenarioManager::init_traci()
         ASSERT(buf.eof());
     }
 
-    {
+    if (useContextSubscription) {
+        subscribeToVehicleContext();
+    }
+    else {
         // subscribe to list of vehicle ids
         simtime_t beginTime = 0;
         simtime_t endTime = SimTime::getMaxTime();
@@ -387,23 +434,34 @@ void TraCIScenarioManager::init_traci()
 
     ObstacleControl* obstacles = ObstacleControlAccess().getIfExists();
     if (obstacles) {
-        {
-            // get list of polygons
-            std::list<std::string> ids = commandInterface->getPolygonIds();
-            for (std::list<std::string>::iterator i = ids.begin(); i != ids.end(); ++i) {
-                std::string id = *i;
-                std::string typeId = commandInterface->polygon(id).getTypeId();
-                if (!obstacles->isTypeSupported(typeId)) continue;
-                std::list<Coord> coords = commandInterface->polygon(id).getShape();
-                std::vector<Coord> shape;
-                std::copy(coords.begin(), coords.end(), std::back_inserter(shape));
-                for (auto p : shape) {
-                    if ((p.x < 0) || (p.y < 0) || (p.x > world->getPgs()->x) || (p.y > world->getPgs()->y)) {
-                        EV_WARN << "WARNING: Playground (" << world->getPgs()->x << ", " << world->getPgs()->y << ") will not fit radio obstacle at (" << p.x << ", " << p.y << ")" << endl;
-                    }
+        std::vector<TraCIPolygonCache::Polygon> polygons;
+        bool cached = false;
+        if (polygonCache) {
+            cached = polygonCacheLoaded.get() && polygonCache->isValidFor(networkBoundaries, par("margin"));
+            if (cached) polygons = polygonCache->getPolygons();
+            // shapes are only cached for the types that could become obstacles when the cache was written
+            for (const auto& polygon : polygons) {
+                cached = cached && (polygon.hasShape || !obstacles->isTypeSupported(polygon.typeId));
+            }
+            EV_DEBUG << (cached ? "using" : "refreshing") << " polygon cache" << endl;
+        }
+        if (!cached) {
+            polygons = fetchPolygons(obstacles);
+            if (polygonCache) polygonCache->store(networkBoundaries, par("margin"), polygons);
+        }
+
+        for (const auto& polygon : polygons) {
+            if (!obstacles->isTypeSupported(polygon.typeId)) continue;
+            for (auto p : polygon.shape) {
+                if ((p.x < 0) || (p.y < 0) || (p.x > world->getPgs()->x) || (p.y > world->getPgs()->y)) {
+                    EV_WARN << "WARNING: Playground (" << world->getPgs()->x << ", " << world->getPgs()->y << ") will not fit radio obstacle at (" << p.x << ", " << p.y << ")" << endl;
                 }
-                obstacles->addFromTypeAndShape(id, typeId, shape);
             }
+            obstacles->addFromTypeAndShape(polygon.id, polygon.typeId, polygon.shape);
+        }
+
+        if (obstacles->usesAttenuationMap()) {
+            obstacles->buildAttenuationMap(fetchLaneShapes());
         }
     }
 
@@ -428,7 +486,7 @@ void TraCIScenarioManager::init_traci()
         pol.push_back(d);
 
         // draw polygon for region of interest
-        if (annotations) {
+        if (!headless && annotations) {
             annotations->drawPolygon(pol, "black");
         }
 
@@ -442,8 +500,8 @@ void TraCIScenarioManager::init_traci()
 
 void TraCIScenarioManager::finish()
 {
-    while (hosts.begin() != hosts.end()) {
-        deleteManagedModule(hosts.begin()->first);
+    for (size_t handle = 0; handle < managedHosts.size(); ++handle) {
+        if (managedHosts[handle].module) deleteManagedModule(handle);
     }
 
     recordScalar("roiArea", areaSum);
@@ -482,26 +540,39 @@ void TraCIScenarioManager::preInitializeModule(cModule* mod, const std::string&
     }
 }
 
-void TraCIScenarioManager::updateModulePosition(cModule* mod, const Coord& p, const std::string& edge, double speed, Heading heading, VehicleSignalSet signals)
+void TraCIScenarioManager::updateModulePosition(ManagedHost& host, const Coord& p, const std::string& edge, double speed, Heading heading, VehicleSignalSet signals)
 {
     // update position in TraCIMobility
-    auto mobilityModules = getSubmodulesOfType<TraCIMobility>(mod);
-    for (auto mm : mobilityModules) {
+    for (auto mm : host.mobilityModules) {
         mm->nextPosition(p, edge, speed, heading, signals);
+        stepPositionDeviation = std::max(stepPositionDeviation, mm->getLastPositionDeviation());
     }
+    updateModulePosition(host.module, p, edge, speed, heading, signals);
+}
+
+void TraCIScenarioManager::updateModulePosition(cModule* mod, const Coord& p, const std::string& edge, double speed, Heading heading, VehicleSignalSet signals)
+{
 }
 
-// name: host;Car;i=vehicle.gif
 void TraCIScenarioManager::addModule(std::string nodeId, std::string type, std::string name, std::string displayString, const Coord& position, std::string road_id, double speed, Heading heading, VehicleSignalSet signals, double length, double height, double width)
 {
+    addModule(internHost(nodeId), type, name, displayString, position, road_id, speed, heading, signals, length, height, width);
+}
+
+// name: host;Car;i=vehicle.gif
+void TraCIScenarioManager::addModule(size_t handle, std::string type, std::string name, std::string displayString, const Coord& position, std::string road_id, double speed, Heading heading, VehicleSignalSet signals, double length, double height, double width)
+{
+    ManagedHost& host = managedHosts[handle];
+    const std::string& nodeId = host.nodeId;
 
-    if (hosts.find(nodeId) != hosts.end()) throw cRuntimeError("tried adding duplicate module");
+    if (host.module || host.isUnequipped) throw cRuntimeError("tried adding duplicate module");
 
-    double option1 = hosts.size() / (hosts.size() + unEquippedHosts.size() + 1.0);
-    double option2 = (hosts.size() + 1) / (hosts.size() + unEquippedHosts.size() + 1.0);
+    double option1 = managedModuleCount / (managedModuleCount + unequippedHostCount + 1.0);
+    double option2 = (managedModuleCount + 1) / (managedModuleCount + unequippedHostCount + 1.0);
 
     if (fabs(option1 - penetrationRate) < fabs(option2 - penetrationRate)) {
-        unEquippedHosts.insert(nodeId);
+        host.isUnequipped = true;
+        unequippedHostCount++;
         return;
     }
 
@@ -510,34 +581,46 @@ void TraCIScenarioManager::addModule(std::string nodeId, std::string type, std::
     cModule* parentmod = getParentModule();
     if (!parentmod) throw cRuntimeError("Parent Module not found");
 
-    cModuleType* nodeType = cModuleType::get(type.c_str());
+    cModuleType*& nodeType = moduleTypeCache[type];
+    if (!nodeType) nodeType = cModuleType::get(type.c_str());
     if (!nodeType) throw cRuntimeError("Module Type \"%s\" not found", type.c_str());
 
     // TODO: this trashes the vectsize member of the cModule, although nobody seems to use it
     cModule* mod = nodeType->create(name.c_str(), parentmod, nodeVectorIndex, nodeVectorIndex);
     mod->finalizeParameters();
-    if (displayString.length() > 0) {
+    if (!headless && displayString.length() > 0) {
         mod->getDisplayString().parse(displayString.c_str());
     }
     mod->buildInside();
-    mod->scheduleStart(simTime() + updateInterval);
+    mod->scheduleStart(simTime() + currentUpdateInterval);
 
     preInitializeModule(mod, nodeId, position, road_id, speed, heading, signals);
 
     emit(traciModulePreInitSignal, mod);
 
     mod->callInitialize();
-    hosts[nodeId] = mod;
+    host.module = mod;
+    host.mobilityModules = getSubmodulesOfType<TraCIMobility>(mod);
+    host.channelAccessModules = getSubmodulesOfType<ChannelAccess>(mod, true);
+    managedModuleCount++;
+
+    if (maxUpdateInterval > updateInterval) {
+        for (auto mm : host.mobilityModules) {
+            if (!mm->setsHostSpeed()) {
+                throw cRuntimeError("maxUpdateInterval (%s) is larger than updateInterval (%s), but %s has setHostSpeed = false: without speed, positions cannot be extrapolated between updates and the update interval would never grow", maxUpdateInterval.str().c_str(), updateInterval.str().c_str(), mm->getFullPath().c_str());
+            }
+        }
+    }
 
     // post-initialize TraCIMobility
-    auto mobilityModules = getSubmodulesOfType<TraCIMobility>(mod);
+    const auto& mobilityModules = host.mobilityModules;
     for (auto mm : mobilityModules) {
         mm->changePosition();
     }
 
     if (vehicleObstacleControl) {
         std::vector<AntennaPosition> initialAntennaPositions;
-        for (auto& caModule : getSubmodulesOfType<ChannelAccess>(mod, true)) {
+        for (auto& caModule : host.channelAccessModules) {
             initialAntennaPositions.push_back(caModule->getAntennaPosition());
         }
         ASSERT(mobilityModules.size() == 1);
@@ -550,49 +633,187 @@ void TraCIScenarioManager::addModule(std::string nodeId, std::string type, std::
     emit(traciModuleAddedSignal, mod);
 }
 
+std::map<std::string, cModule*> TraCIScenarioManager::getManagedHosts() const
+{
+    std::map<std::string, cModule*> hosts;
+    for (const auto& host : managedHosts) {
+        if (host.module) hosts[host.nodeId] = host.module;
+    }
+    return hosts;
+}
+
 cModule* TraCIScenarioManager::getManagedModule(std::string nodeId)
 {
-    if (hosts.find(nodeId) == hosts.end()) return nullptr;
-    return hosts[nodeId];
+    ManagedHost* host = getManagedHost(nodeId);
+    return host ? host->module : nullptr;
+}
+
+size_t TraCIScenarioManager::internHost(const std::string& nodeId)
+{
+    auto inserted = hostHandles.emplace(nodeId, managedHosts.size());
+    if (!inserted.second) return inserted.first->second;
+
+    if (freeHostHandles.empty()) {
+        managedHosts.emplace_back();
+    }
+    else {
+        inserted.first->second = freeHostHandles.back();
+        freeHostHandles.pop_back();
+    }
+    managedHosts[inserted.first->second].nodeId = nodeId;
+    return inserted.first->second;
+}
+
+TraCIScenarioManager::ManagedHost* TraCIScenarioManager::getManagedHost(const std::string& nodeId)
+{
+    auto i = hostHandles.find(nodeId);
+    if (i == hostHandles.end()) return nullptr;
+    return &managedHosts[i->second];
+}
+
+void TraCIScenarioManager::releaseHost(size_t handle)
+{
+    ManagedHost& host = managedHosts[handle];
+    if (host.module) deleteManagedModule(handle);
+    if (host.isUnequipped) unequippedHostCount--;
+    hostHandles.erase(host.nodeId);
+    host = ManagedHost();
+    freeHostHandles.push_back(handle);
 }
 
 bool TraCIScenarioManager::isModuleUnequipped(std::string nodeId)
 {
-    if (unEquippedHosts.find(nodeId) == unEquippedHosts.end()) return false;
-    return true;
+    ManagedHost* host = getManagedHost(nodeId);
+    return host && host->isUnequipped;
+}
+
+const TraCIScenarioManager::VehicleModuleTemplate& TraCIScenarioManager::getVehicleModuleTemplate(const std::string& vType)
+{
+    auto cached = vehicleModuleTemplates.find(vType);
+    if (cached != vehicleModuleTemplates.end()) return cached->second;
+
+    VehicleModuleTemplate moduleTemplate;
+    TypeMapping::iterator iType, iName, iDisplayString;
+
+    iType = moduleType.find(vType);
+    if (iType == moduleType.end()) {
+        iType = moduleType.find("*");
+        if (iType == moduleType.end()) throw cRuntimeError("cannot find a module type for vehicle type \"%s\"", vType.c_str());
+    }
+    moduleTemplate.type = iType->second;
+    // search for module name
+    iName = moduleName.find(vType);
+    if (iName == moduleName.end()) {
+        iName = moduleName.find(std::string("*"));
+        if (iName == moduleName.end()) throw cRuntimeError("cannot find a module name for vehicle type \"%s\"", vType.c_str());
+    }
+    moduleTemplate.name = iName->second;
+    if (moduleDisplayString.size() != 0) {
+        iDisplayString = moduleDisplayString.find(vType);
+        if (iDisplayString == moduleDisplayString.end()) {
+            iDisplayString = moduleDisplayString.find("*");
+            if (iDisplayString == moduleDisplayString.end()) throw cRuntimeError("cannot find a module display string for vehicle type \"%s\"", vType.c_str());
+        }
+        moduleTemplate.displayString = iDisplayString->second;
+    }
+
+    return vehicleModuleTemplates[vType] = moduleTemplate;
 }
 
 void TraCIScenarioManager::deleteManagedModule(std::string nodeId)
 {
-    cModule* mod = getManagedModule(nodeId);
-    if (!mod) throw cRuntimeError("no vehicle with Id \"%s\" found", nodeId.c_str());
+    auto handle = hostHandles.find(nodeId);
+    if (handle == hostHandles.end() || !managedHosts[handle->second].module) throw cRuntimeError("no vehicle with Id \"%s\" found", nodeId.c_str());
+    deleteManagedModule(handle->second);
+}
+
+void TraCIScenarioManager::deleteManagedModule(size_t handle)
+{
+    ManagedHost& host = managedHosts[handle];
+    cModule* mod = host.module;
+    ASSERT(mod);
 
     emit(traciModuleRemovedSignal, mod);
 
-    auto cas = getSubmodulesOfType<ChannelAccess>(mod, true);
-    for (auto ca : cas) {
+    for (auto ca : host.channelAccessModules) {
         cModule* nic = ca->getParentModule();
         auto connectionManager = ChannelAccess::getConnectionManager(nic);
         connectionManager->unregisterNic(nic);
     }
     if (vehicleObstacleControl) {
-        for (cModule::SubmoduleIterator iter(mod); !iter.end(); iter++) {
-            cModule* submod = *iter;
-            TraCIMobility* mm = dynamic_cast<TraCIMobility*>(submod);
-            if (!mm) continue;
+        for (auto mm : host.mobilityModules) {
             auto vo = vehicleObstacles.find(mm);
             ASSERT(vo != vehicleObstacles.end());
             vehicleObstacleControl->erase(vo->second);
         }
     }
 
-    hosts.erase(nodeId);
+    host.module = nullptr;
+    host.mobilityModules.clear();
+    host.channelAccessModules.clear();
+    managedModuleCount--;
     mod->callFinish();
     mod->deleteModule();
 }
 
+std::vector<TraCIPolygonCache::Polygon> TraCIScenarioManager::fetchPolygons(ObstacleControl* obstacles)
+{
+    // one round trip for all types and one for all shapes, instead of two per polygon
+    auto* commandInterface = getCommandInterface();
+    std::list<std::string> ids = commandInterface->getPolygonIds();
+    std::vector<TraCIPolygonCache::Polygon> polygons;
+    polygons.reserve(ids.size());
+    auto batch = commandInterface->batch();
+    std::vector<TraCICommandInterface::Batch::Value<std::string>> typeIds;
+    typeIds.reserve(ids.size());
+    for (const auto& id : ids) {
+        polygons.emplace_back();
+        polygons.back().id = id;
+        typeIds.push_back(batch.polygon(id).getTypeId());
+    }
+    batch.execute();
+
+    std::vector<std::pair<size_t, TraCICommandInterface::Batch::Value<std::list<Coord>>>> shapes;
+    for (size_t i = 0; i < polygons.size(); ++i) {
+        polygons[i].typeId = typeIds[i].get();
+        if (!obstacles->isTypeSupported(polygons[i].typeId)) continue;
+        shapes.emplace_back(i, batch.polygon(polygons[i].id).getShape());
+    }
+    batch.execute();
+
+    for (const auto& shape : shapes) {
+        auto& polygon = polygons[shape.first];
+        const std::list<Coord>& coords = shape.second.get();
+        polygon.shape.assign(coords.begin(), coords.end());
+        polygon.hasShape = true;
+    }
+    return polygons;
+}
+
+std::vector<std::vector<Coord>> TraCIScenarioManager::fetchLaneShapes()
+{
+    auto* commandInterface = getCommandInterface();
+    std::list<std::string> ids = commandInterface->getLaneIds();
+    auto batch = commandInterface->batch();
+    std::vector<TraCICommandInterface::Batch::Value<std::list<Coord>>> shapes;
+    shapes.reserve(ids.size());
+    for (const auto& id : ids) {
+        shapes.push_back(batch.getCoordList(CMD_GET_LANE_VARIABLE, id, VAR_SHAPE, RESPONSE_GET_LANE_VARIABLE));
+    }
+    batch.execute();
+
+    std::vector<std::vector<Coord>> laneShapes;
+    laneShapes.reserve(shapes.size());
+    for (const auto& shape : shapes) {
+        const std::list<Coord>& coords = shape.get();
+        laneShapes.emplace_back(coords.begin(), coords.end());
+    }
+    return laneShapes;
+}
+
 void TraCIScenarioManager::executeOneTimestep()
 {
+    VEINS_PROFILE_SCOPE("TraCIScenarioManager::executeOneTimestep");
 
     EV_DEBUG << "Triggering TraCI server simulation advance to t=" << simTime() << endl;
 
@@ -601,7 +822,13 @@ void TraCIScenarioManager::executeOneTimestep()
     emit(traciTimestepBeginSignal, targetTime);
 
     if (isConnected()) {
-        TraCIBuffer buf = connection->query(CMD_SIMSTEP2, TraCIBuffer() << targetTime);
+        TraCIBuffer buf;
+        {
+            // profiled separately: time spent waiting for SUMO
+            VEINS_PROFILE_SCOPE("TraCIScenarioManager::executeOneTimestep:simulationStep");
+            // in lookahead mode, the command for this timestep has been sent at the end of the previous one
+            buf = connection->hasPendingQuery() ? connection->finishQuery() : connection->query(CMD_SIMSTEP2, TraCIBuffer() << targetTime);
+        }
 
         uint32_t count;
         buf >> count;
@@ -613,7 +840,31 @@ void TraCIScenarioManager::executeOneTimestep()
 
     emit(traciTimestepEndSignal, targetTime);
 
-    if (!autoShutdownTriggered) scheduleAt(simTime() + updateInterval, executeOneTimestepTrigger);
+    if (maxUpdateInterval > updateInterval) adaptUpdateInterval();
+
+    if (!autoShutdownTriggered) {
+        scheduleAt(simTime() + currentUpdateInterval, executeOneTimestepTrigger);
+        if (lookahead && isConnected()) connection->startQuery(CMD_SIMSTEP2, TraCIBuffer() << simTime() + currentUpdateInterval);
+    }
+}
+
+void TraCIScenarioManager::adaptUpdateInterval()
+{
+    // positions in between updates are linearly extrapolated, so fall back to fine updates as soon as a vehicle deviates too much (e.g., when turning or braking)
+    simtime_t nextUpdateInterval = currentUpdateInterval;
+    if (stepPositionDeviation > maxPositionDeviation) {
+        nextUpdateInterval = updateInterval;
+    }
+    else if (stepPositionDeviation <= maxPositionDeviation / 2) {
+        nextUpdateInterval = std::min(currentUpdateInterval * 2, maxUpdateInterval);
+        // stay on a multiple of updateInterval
+        nextUpdateInterval.setRaw(nextUpdateInterval.raw() - nextUpdateInterval.raw() % updateInterval.raw());
+    }
+    if (nextUpdateInterval != currentUpdateInterval) {
+        EV_DEBUG << "largest position deviation was " << stepPositionDeviation << "m, changing update interval to " << nextUpdateInterval << endl;
+        currentUpdateInterval = nextUpdateInterval;
+    }
+    stepPositionDeviation = 0;
 }
 
 void TraCIScenarioManager::subscribeToVehicleVariables(std::string vehicleId)
@@ -637,6 +888,40 @@ void TraCIScenarioManager::subscribeToVehicleVariables(std::string vehicleId)
     ASSERT(buf.eof());
 }
 
+void TraCIScenarioManager::subscribeToVehicleContext()
+{
+    // subscribe to some attributes of all vehicles: the simulation context contains every vehicle, regardless of range
+    uint8_t commandId = CMD_SUBSCRIBE_SIM_CONTEXT;
+    simtime_t beginTime = 0;
+    simtime_t endTime = SimTime::getMaxTime();
+    std::string objectId = "";
+    uint8_t contextDomain = CMD_GET_VEHICLE_VARIABLE;
+    double range = 0;
+    if (roiSubscriptionFilter) {
+        // only subscribe to the vehicles in range of a POI in the center of the ROI rectangles, covering all of them
+        auto bounds = roi.getRectanglesBoundingBox();
+        TraCICoord center((bounds.first.x + bounds.second.x) / 2, (bounds.first.y + bounds.second.y) / 2);
+        commandIfc->addPoi(roiPoiId, roiPoiId, TraCIColor(0, 0, 0, 0), 0, connection->traci2omnet(center));
+        commandId = CMD_SUBSCRIBE_POI_CONTEXT;
+        objectId = roiPoiId;
+        range = std::hypot(bounds.second.x - bounds.first.x, bounds.second.y - bounds.first.y) / 2 + roiPoiRangeMargin;
+    }
+    uint8_t variableNumber = 9;
+    uint8_t variable1 = VAR_POSITION;
+    uint8_t variable2 = VAR_ROAD_ID;
+    uint8_t variable3 = VAR_SPEED;
+    uint8_t variable4 = VAR_ANGLE;
+    uint8_t variable5 = VAR_SIGNALS;
+    uint8_t variable6 = VAR_LENGTH;
+    uint8_t variable7 = VAR_HEIGHT;
+    uint8_t variable8 = VAR_WIDTH;
+    uint8_t variable9 = VAR_TYPE;
+
+    TraCIBuffer buf = connection->query(commandId, TraCIBuffer() << beginTime << endTime << objectId << contextDomain << range << variableNumber << variable1 << variable2 << variable3 << variable4 << variable5 << variable6 << variable7 << variable8 << variable9);
+    processSubcriptionResult(buf);
+    ASSERT(buf.eof());
+}
+
 void TraCIScenarioManager::unsubscribeFromVehicleVariables(std::string vehicleId)
 {
     // subscribe to some attributes of the vehicle
@@ -778,13 +1063,9 @@ void TraCIScenarioManager::processSimSubscription(std::string objectId, TraCIBuf
                     // no unsubscription via TraCI possible/necessary as of SUMO 1.0.0 (the vehicle has arrived)
                 }
 
-                // check if this object has been deleted already (e.g. because it was outside the ROI)
-                cModule* mod = getManagedModule(idstring);
-                if (mod) deleteManagedModule(idstring);
-
-                if (unEquippedHosts.find(idstring) != unEquippedHosts.end()) {
-                    unEquippedHosts.erase(idstring);
-                }
+                // the vehicle has left the network: delete its module (unless it was deleted already, e.g. because it was outside the ROI) and forget it
+                auto handle = hostHandles.find(idstring);
+                if (handle != hostHandles.end()) releaseHost(handle->second);
             }
 
             if ((count > 0) && (count >= activeVehicleCount) && autoShutdown) autoShutdownTriggered = true;
@@ -802,13 +1083,9 @@ void TraCIScenarioManager::processSimSubscription(std::string objectId, TraCIBuf
                 std::string idstring;
                 buf >> idstring;
 
-                // check if this object has been deleted already (e.g. because it was outside the ROI)
-                cModule* mod = getManagedModule(idstring);
-                if (mod) deleteManagedModule(idstring);
-
-                if (unEquippedHosts.find(idstring) != unEquippedHosts.end()) {
-                    unEquippedHosts.erase(idstring);
-                }
+                // the vehicle has left the network: delete its module (unless it was deleted already, e.g. because it was outside the ROI) and forget it
+                auto handle = hostHandles.find(idstring);
+                if (handle != hostHandles.end()) releaseHost(handle->second);
             }
 
             activeVehicleCount -= count;
@@ -841,9 +1118,9 @@ void TraCIScenarioManager::processSimSubscription(std::string objectId, TraCIBuf
                 std::string idstring;
                 buf >> idstring;
 
-                cModule* mod = getManagedModule(idstring);
-                auto mobilityModules = getSubmodulesOfType<TraCIMobility>(mod);
-                for (auto mm : mobilityModules) {
+                ManagedHost* host = getManagedHost(idstring);
+                if (!host) continue;
+                for (auto mm : host->mobilityModules) {
                     mm->changeParkingState(true);
                 }
             }
@@ -862,9 +1139,9 @@ void TraCIScenarioManager::processSimSubscription(std::string objectId, TraCIBuf
                 std::string idstring;
                 buf >> idstring;
 
-                cModule* mod = getManagedModule(idstring);
-                auto mobilityModules = getSubmodulesOfType<TraCIMobility>(mod);
-                for (auto mm : mobilityModules) {
+                ManagedHost* host = getManagedHost(idstring);
+                if (!host) continue;
+                for (auto mm : host->mobilityModules) {
                     mm->changeParkingState(false);
                 }
             }
@@ -887,19 +1164,60 @@ void TraCIScenarioManager::processSimSubscription(std::string objectId, TraCIBuf
     }
 }
 
+bool TraCIScenarioManager::readVehicleVariable(uint8_t variable, TraCIBuffer& buf, VehicleSubscriptionState& state)
+{
+    uint8_t varType;
+    buf >> varType;
+    if (variable == VAR_POSITION) {
+        ASSERT(varType == POSITION_2D);
+        buf >> state.px;
+        buf >> state.py;
+    }
+    else if (variable == VAR_ROAD_ID) {
+        ASSERT(varType == TYPE_STRING);
+        buf >> state.edge;
+    }
+    else if (variable == VAR_SPEED) {
+        ASSERT(varType == TYPE_DOUBLE);
+        buf >> state.speed;
+    }
+    else if (variable == VAR_ANGLE) {
+        ASSERT(varType == TYPE_DOUBLE);
+        buf >> state.angle_traci;
+    }
+    else if (variable == VAR_SIGNALS) {
+        ASSERT(varType == TYPE_INTEGER);
+        buf >> state.signals;
+    }
+    else if (variable == VAR_LENGTH) {
+        ASSERT(varType == TYPE_DOUBLE);
+        buf >> state.length;
+    }
+    else if (variable == VAR_HEIGHT) {
+        ASSERT(varType == TYPE_DOUBLE);
+        buf >> state.height;
+    }
+    else if (variable == VAR_WIDTH) {
+        ASSERT(varType == TYPE_DOUBLE);
+        buf >> state.width;
+    }
+    else if (variable == VAR_TYPE) {
+        ASSERT(varType == TYPE_STRING);
+        buf >> state.typeId;
+        // not counted in numRead: only reported by context subscriptions
+        return true;
+    }
+    else {
+        return false;
+    }
+    state.numRead++;
+    return true;
+}
+
 void TraCIScenarioManager::processVehicleSubscription(std::string objectId, TraCIBuffer& buf)
 {
     bool isSubscribed = (subscribedVehicles.find(objectId) != subscribedVehicles.end());
-    double px;
-    double py;
-    std::string edge;
-    double speed;
-    double angle_traci;
-    int signals;
-    double length;
-    double height;
-    double width;
-    int numRead = 0;
+    VehicleSubscriptionState state;
 
     uint8_t variableNumber_resp;
     buf >> variableNumber_resp;
@@ -950,64 +1268,7 @@ void TraCIScenarioManager::processVehicleSubscription(std::string objectId, TraC
                 unsubscribeFromVehicleVariables(*i);
             }
         }
-        else if (variable1_resp == VAR_POSITION) {
-            uint8_t varType;
-            buf >> varType;
-            ASSERT(varType == POSITION_2D);
-            buf >> px;
-            buf >> py;
-            numRead++;
-        }
-        else if (variable1_resp == VAR_ROAD_ID) {
-            uint8_t varType;
-            buf >> varType;
-            ASSERT(varType == TYPE_STRING);
-            buf >> edge;
-            numRead++;
-        }
-        else if (variable1_resp == VAR_SPEED) {
-            uint8_t varType;
-            buf >> varType;
-            ASSERT(varType == TYPE_DOUBLE);
-            buf >> speed;
-            numRead++;
-        }
-        else if (variable1_resp == VAR_ANGLE) {
-            uint8_t varType;
-            buf >> varType;
-            ASSERT(varType == TYPE_DOUBLE);
-            buf >> angle_traci;
-            numRead++;
-        }
-        else if (variable1_resp == VAR_SIGNALS) {
-            uint8_t varType;
-            buf >> varType;
-            ASSERT(varType == TYPE_INTEGER);
-            buf >> signals;
-            numRead++;
-        }
-        else if (variable1_resp == VAR_LENGTH) {
-            uint8_t varType;
-            buf >> varType;
-            ASSERT(varType == TYPE_DOUBLE);
-            buf >> length;
-            numRead++;
-        }
-        else if (variable1_resp == VAR_HEIGHT) {
-            uint8_t varType;
-            buf >> varType;
-            ASSERT(varType == TYPE_DOUBLE);
-            buf >> height;
-            numRead++;
-        }
-        else if (variable1_resp == VAR_WIDTH) {
-            uint8_t varType;
-            buf >> varType;
-            ASSERT(varType == TYPE_DOUBLE);
-            buf >> width;
-            numRead++;
-        }
-        else {
+        else if (!readVehicleVariable(variable1_resp, buf, state)) {
             throw cRuntimeError("Received unhandled vehicle subscription result");
         }
     }
@@ -1016,74 +1277,113 @@ void TraCIScenarioManager::processVehicleSubscription(std::string objectId, TraC
     if (!isSubscribed) return;
 
     // make sure we got updates for all attributes
-    if (numRead != 8) return;
+    if (state.numRead != 8) return;
+
+    updateVehicle(objectId, state);
+}
+
+void TraCIScenarioManager::processVehicleContextSubscription(std::string objectId, TraCIBuffer& buf)
+{
+    uint8_t contextDomain;
+    buf >> contextDomain;
+    ASSERT(contextDomain == CMD_GET_VEHICLE_VARIABLE);
+    uint8_t variableNumber_resp;
+    buf >> variableNumber_resp;
+    uint32_t vehicleCount;
+    buf >> vehicleCount;
+    EV_DEBUG << "TraCI reports " << vehicleCount << " active vehicles." << endl;
+
+    std::unordered_set<std::string> reportedVehicles;
+    for (uint32_t i = 0; i < vehicleCount; ++i) {
+        std::string vehicleId;
+        buf >> vehicleId;
+        if (roiSubscriptionFilter) reportedVehicles.insert(vehicleId);
+        VehicleSubscriptionState state;
+        for (uint8_t j = 0; j < variableNumber_resp; ++j) {
+            uint8_t variable1_resp;
+            buf >> variable1_resp;
+            uint8_t isokay;
+            buf >> isokay;
+            if (isokay != RTYPE_OK) {
+                uint8_t varType;
+                buf >> varType;
+                ASSERT(varType == TYPE_STRING);
+                std::string errormsg;
+                buf >> errormsg;
+                if (isokay == RTYPE_NOTIMPLEMENTED) throw cRuntimeError("TraCI server reported subscribing to vehicle variable 0x%2x not implemented (\"%s\"). Might need newer version.", variable1_resp, errormsg.c_str());
+                throw cRuntimeError("TraCI server reported error subscribing to vehicle variable 0x%2x (\"%s\").", variable1_resp, errormsg.c_str());
+            }
+            if (!readVehicleVariable(variable1_resp, buf, state)) {
+                throw cRuntimeError("Received unhandled vehicle context subscription result");
+            }
+        }
+
+        // make sure we got updates for all attributes
+        if (state.numRead != 8) continue;
+
+        updateVehicle(vehicleId, state);
+    }
+
+    if (roiSubscriptionFilter) {
+        // vehicles no longer reported have left the range of the filter (and the ROI), possibly without being seen outside the ROI first
+        for (size_t handle = 0; handle < managedHosts.size(); ++handle) {
+            const ManagedHost& host = managedHosts[handle];
+            if (host.nodeId.empty() || reportedVehicles.count(host.nodeId)) continue;
+            if (std::any_of(host.mobilityModules.begin(), host.mobilityModules.end(), [](TraCIMobility* mm) { return mm->getParkingState(); })) continue;
+            if (host.module) EV_DEBUG << "Vehicle #" << host.nodeId << " left region of interest" << endl;
+            releaseHost(handle);
+        }
+    }
+}
+
+void TraCIScenarioManager::updateVehicle(const std::string& objectId, const VehicleSubscriptionState& state)
+{
+    const double px = state.px;
+    const double py = state.py;
+    const std::string& edge = state.edge;
+    const double speed = state.speed;
 
     Coord p = connection->traci2omnet(TraCICoord(px, py));
     if ((p.x < 0) || (p.y < 0)) throw cRuntimeError("received bad node position (%.2f, %.2f), translated to (%.2f, %.2f)", px, py, p.x, p.y);
 
-    Heading heading = connection->traci2omnetHeading(angle_traci);
+    Heading heading = connection->traci2omnetHeading(state.angle_traci);
 
-    cModule* mod = getManagedModule(objectId);
+    const size_t handle = internHost(objectId);
+    ManagedHost& host = managedHosts[handle];
 
     // is it in the ROI?
     bool inRoi = !roi.hasConstraints() ? true : (roi.onAnyRectangle(TraCICoord(px, py)) || roi.partOfRoads(edge));
     if (!inRoi) {
-        if (mod) {
-            deleteManagedModule(objectId);
+        if (host.module) {
+            deleteManagedModule(handle);
             EV_DEBUG << "Vehicle #" << objectId << " left region of interest" << endl;
         }
-        else if (unEquippedHosts.find(objectId) != unEquippedHosts.end()) {
-            unEquippedHosts.erase(objectId);
+        else if (host.isUnequipped) {
+            host.isUnequipped = false;
+            unequippedHostCount--;
             EV_DEBUG << "Vehicle (unequipped) # " << objectId << " left region of interest" << endl;
         }
         return;
     }
 
-    if (isModuleUnequipped(objectId)) {
+    if (host.isUnequipped) {
         return;
     }
 
-    if (!mod) {
+    if (!host.module) {
         // no such module - need to create
-        std::string vType = commandIfc->vehicle(objectId).getTypeId();
-        std::string mType, mName, mDisplayString;
-        TypeMapping::iterator iType, iName, iDisplayString;
-
-        TypeMapping::iterator i;
-        iType = moduleType.find(vType);
-        if (iType == moduleType.end()) {
-            iType = moduleType.find("*");
-            if (iType == moduleType.end()) throw cRuntimeError("cannot find a module type for vehicle type \"%s\"", vType.c_str());
-        }
-        mType = iType->second;
-        // search for module name
-        iName = moduleName.find(vType);
-        if (iName == moduleName.end()) {
-            iName = moduleName.find(std::string("*"));
-            if (iName == moduleName.end()) throw cRuntimeError("cannot find a module name for vehicle type \"%s\"", vType.c_str());
-        }
-        mName = iName->second;
-        if (moduleDisplayString.size() != 0) {
-            iDisplayString = moduleDisplayString.find(vType);
-            if (iDisplayString == moduleDisplayString.end()) {
-                iDisplayString = moduleDisplayString.find("*");
-                if (iDisplayString == moduleDisplayString.end()) throw cRuntimeError("cannot find a module display string for vehicle type \"%s\"", vType.c_str());
-            }
-            mDisplayString = iDisplayString->second;
-        }
-        else {
-            mDisplayString = "";
-        }
+        std::string vType = state.typeId.empty() ? commandIfc->vehicle(objectId).getTypeId() : state.typeId;
+        const VehicleModuleTemplate& moduleTemplate = getVehicleModuleTemplate(vType);
 
-        if (mType != "0") {
-            addModule(objectId, mType, mName, mDisplayString, p, edge, speed, heading, VehicleSignalSet(signals), length, height, width);
+        if (moduleTemplate.type != "0") {
+            addModule(handle, moduleTemplate.type, moduleTemplate.name, moduleTemplate.displayString, p, edge, speed, heading, VehicleSignalSet(state.signals), state.length, state.height, state.width);
             EV_DEBUG << "Added vehicle #" << objectId << endl;
         }
     }
     else {
         // module existed - update position
         EV_DEBUG << "module " << objectId << " moving to " << p.x << "," << p.y << endl;
-        updateModulePosition(mod, p, edge, speed, heading, VehicleSignalSet(signals));
+        updateModulePosition(host, p, edge, speed, heading, VehicleSignalSet(state.signals));
     }
 }
 
@@ -1100,6 +1400,8 @@ void TraCIScenarioManager::processSubcriptionResult(TraCIBuffer& buf)
 
     if (commandId_resp == RESPONSE_SUBSCRIBE_VEHICLE_VARIABLE)
         processVehicleSubscription(objectId_resp, buf);
+    else if (commandId_resp == RESPONSE_SUBSCRIBE_SIM_CONTEXT || commandId_resp == RESPONSE_SUBSCRIBE_POI_CONTEXT)
+        processVehicleContextSubscription(objectId_resp, buf);
     else if (commandId_resp == RESPONSE_SUBSCRIBE_SIM_VARIABLE)
         processSimSubscription(objectId_resp, buf);
     else if (commandId_resp == RESPONSE_SUBSCRIBE_TL_VARIABLE)
@@ -22,10 +22,12 @@
 
 #pragma once
 
+#include <future>
 #include <map>
 #include <memory>
 #include <list>
 #include <queue>
+#include <unordered_map>
 
 #include "veins/veins.h"
 
@@ -39,6 +41,7 @@
 #include "veins/modules/mobility/traci/TraCIColor.h"
 #include "veins/modules/mobility/traci/TraCIConnection.h"
 #include "veins/modules/mobility/traci/TraCICoord.h"
+#include "veins/modules/mobility/traci/TraCIPolygonCache.h"
 #include "veins/modules/mobility/traci/VehicleSignal.h"
 #include "veins/modules/mobility/traci/TraCIRegionOfInterest.h"
 
@@ -46,6 +49,8 @@ namespace veins {
 
 class TraCICommandInterface;
 class MobileHostObstacle;
+class TraCIMobility;
+class ChannelAccess;
 
 /**
  * @brief
@@ -104,9 +109,14 @@ public:
         return autoShutdownTriggered;
     }
 
-    const std::map<std::string, cModule*>& getManagedHosts()
+    /**
+     * returns all hosts managed by us (i.e., all vehicles that have a module), by SUMO ID
+     */
+    std::map<std::string, cModule*> getManagedHosts() const;
+
+    size_t getManagedHostCount() const
     {
-        return hosts;
+        return managedModuleCount;
     }
 
     /**
@@ -124,11 +134,26 @@ protected:
     simtime_t connectAt; /**< when to connect to TraCI server (must be the initial timestep of the server) */
     simtime_t firstStepAt; /**< when to start synchronizing with the TraCI server (-1: immediately after connecting) */
     simtime_t updateInterval; /**< time interval of hosts' position updates */
+    simtime_t maxUpdateInterval; /**< upper bound of currentUpdateInterval (if larger than updateInterval) */
+    double maxPositionDeviation; /**< largest tolerated distance of a received vehicle position from its extrapolation before falling back to updateInterval */
+    simtime_t currentUpdateInterval; /**< time interval until the next position update */
+    double stepPositionDeviation; /**< largest distance of a received vehicle position from its extrapolation in the current timestep */
     // maps from vehicle type to moduleType, moduleName, and moduleDisplayString
     typedef std::map<std::string, std::string> TypeMapping;
     TypeMapping moduleType; /**< module type to be used in the simulation for each managed vehicle */
     TypeMapping moduleName; /**< module name to be used in the simulation for each managed vehicle */
     TypeMapping moduleDisplayString; /**< module displayString to be used in the simulation for each managed vehicle */
+
+    /**
+     * module type, name, and display string to be used for vehicles of one vehicle type (resolved from the mappings above)
+     */
+    struct VehicleModuleTemplate {
+        std::string type;
+        std::string name;
+        std::string displayString;
+    };
+    std::map<std::string, VehicleModuleTemplate> vehicleModuleTemplates; /**< cache of resolved templates, by vehicle type */
+    std::map<std::string, cModuleType*> moduleTypeCache; /**< cache of looked up module types, by NED type name */
     std::string host;
     int port;
 
@@ -138,6 +163,9 @@ protected:
     std::vector<std::string> trafficLightModuleIds; /**< list of traffic light module ids that is subscribed to (whitelist) */
 
     bool autoShutdown; /**< Shutdown module as soon as no more vehicles are in the simulation */
+    bool useContextSubscription; /**< receive the variables of all vehicles in one context subscription result per timestep instead of subscribing to each vehicle */
+    bool roiSubscriptionFilter; /**< subscribe to the context of a POI covering the ROI rectangles instead of the whole simulation */
+    bool lookahead; /**< ask the TraCI server for the next timestep right away, receiving its results in the background */
     double penetrationRate;
     bool ignoreGuiCommands; /**< whether to ignore all TraCI commands that only make sense when the server has a graphical user interface */
     TraCIRegionOfInterest roi; /**< Can return whether a given position lies within the simulation's region of interest. Modules are destroyed and re-created as managed vehicles leave and re-enter the ROI */
@@ -146,10 +174,26 @@ protected:
     AnnotationManager* annotations;
     std::unique_ptr<TraCIConnection> connection;
     std::unique_ptr<TraCICommandInterface> commandIfc;
+    std::unique_ptr<TraCIPolygonCache> polygonCache; /**< cache of the polygons fetched at startup (nullptr if disabled) */
+    std::future<bool> polygonCacheLoaded; /**< whether polygonCache could be loaded (done in the background while the TraCI server starts up) */
 
     size_t nextNodeVectorIndex; /**< next OMNeT++ module vector index to use */
-    std::map<std::string, cModule*> hosts; /**< vector of all hosts managed by us */
-    std::set<std::string> unEquippedHosts;
+
+    /**
+     * a vehicle reported by the TraCI server, along with its module and the submodules the manager accesses on each update (found once, when the module is added)
+     */
+    struct ManagedHost {
+        std::string nodeId; /**< SUMO ID */
+        cModule* module = nullptr; /**< nullptr if the vehicle has no module (e.g., it is unequipped or outside the ROI) */
+        bool isUnequipped = false;
+        std::vector<TraCIMobility*> mobilityModules;
+        std::vector<ChannelAccess*> channelAccessModules;
+    };
+    std::vector<ManagedHost> managedHosts; /**< all vehicles seen since they (last) entered the network, indexed by handle; handles of released vehicles are reused */
+    std::vector<size_t> freeHostHandles; /**< handles not currently in use */
+    std::unordered_map<std::string, size_t> hostHandles; /**< handle of each vehicle in managedHosts, by SUMO ID */
+    size_t managedModuleCount = 0; /**< number of vehicles in managedHosts that have a module */
+    size_t unequippedHostCount = 0; /**< number of vehicles in managedHosts that are unequipped */
     std::set<std::string> subscribedVehicles; /**< all vehicles we have already subscribed to */
     std::map<std::string, cModule*> trafficLights; /**< vector of all traffic lights managed by us */
     uint32_t activeVehicleCount; /**< number of vehicles, be it parking or driving **/
@@ -164,21 +208,61 @@ protected:
     VehicleObstacleControl* vehicleObstacleControl;
 
     void executeOneTimestep(); /**< read and execute all commands for the next timestep */
+    void adaptUpdateInterval(); /**< pick currentUpdateInterval based on stepPositionDeviation */
 
     virtual void init_traci();
 
+    /**
+     * fetch the ID and type of all polygons from the TraCI server, as well as the shape of all polygons that can become obstacles
+     */
+    std::vector<TraCIPolygonCache::Polygon> fetchPolygons(ObstacleControl* obstacles);
+
+    /**
+     * fetch the shape of all lanes from the TraCI server
+     */
+    std::vector<std::vector<Coord>> fetchLaneShapes();
+
     virtual void preInitializeModule(cModule* mod, const std::string& nodeId, const Coord& position, const std::string& road_id, double speed, Heading heading, VehicleSignalSet signals);
-    virtual void updateModulePosition(cModule* mod, const Coord& p, const std::string& edge, double speed, Heading heading, VehicleSignalSet signals);
+    void updateModulePosition(ManagedHost& host, const Coord& p, const std::string& edge, double speed, Heading heading, VehicleSignalSet signals); /**< update the TraCIMobility submodules of host, then call the virtual overload */
+    virtual void updateModulePosition(cModule* mod, const Coord& p, const std::string& edge, double speed, Heading heading, VehicleSignalSet signals); /**< hook for subclasses to update other submodules of mod; its TraCIMobility submodules have already been updated */
     void addModule(std::string nodeId, std::string type, std::string name, std::string displayString, const Coord& position, std::string road_id = "", double speed = -1, Heading heading = Heading::nan, VehicleSignalSet signals = {VehicleSignal::undefined}, double length = 0, double height = 0, double width = 0);
+    void addModule(size_t handle, std::string type, std::string name, std::string displayString, const Coord& position, std::string road_id = "", double speed = -1, Heading heading = Heading::nan, VehicleSignalSet signals = {VehicleSignal::undefined}, double length = 0, double height = 0, double width = 0);
     cModule* getManagedModule(std::string nodeId); /**< returns a pointer to the managed module named moduleName, or 0 if no module can be found */
+    size_t internHost(const std::string& nodeId); /**< returns the handle of the vehicle with the given SUMO ID, assigning a new one if it has not been seen before */
+    ManagedHost* getManagedHost(const std::string& nodeId); /**< returns the vehicle with the given SUMO ID, or nullptr if it has not been seen (since it last entered the network) */
+    void releaseHost(size_t handle); /**< forget a vehicle, deleting its module (if any), and free its handle */
     void deleteManagedModule(std::string nodeId);
+    void deleteManagedModule(size_t handle);
 
     bool isModuleUnequipped(std::string nodeId); /**< returns true if this vehicle is Unequipped */
 
+    const VehicleModuleTemplate& getVehicleModuleTemplate(const std::string& vType); /**< returns module type, name, and display string for vehicles of type vType */
+
+    /**
+     * variables of one vehicle, as reported by a subscription result
+     */
+    struct VehicleSubscriptionState {
+        double px = 0;
+        double py = 0;
+        std::string edge;
+        double speed = 0;
+        double angle_traci = 0;
+        int signals = 0;
+        double length = 0;
+        double height = 0;
+        double width = 0;
+        std::string typeId; /**< empty if not reported */
+        int numRead = 0; /**< number of variables read (not counting typeId) */
+    };
+
     void subscribeToVehicleVariables(std::string vehicleId);
     void unsubscribeFromVehicleVariables(std::string vehicleId);
+    void subscribeToVehicleContext();
     void processSimSubscription(std::string objectId, TraCIBuffer& buf);
     void processVehicleSubscription(std::string objectId, TraCIBuffer& buf);
+    void processVehicleContextSubscription(std::string objectId, TraCIBuffer& buf);
+    bool readVehicleVariable(uint8_t variable, TraCIBuffer& buf, VehicleSubscriptionState& state); /**< read the value of a vehicle variable into state, returns false if variable is unknown */
+    void updateVehicle(const std::string& objectId, const VehicleSubscriptionState& state); /**< create, move, or delete the module of a vehicle according to its subscribed variables */
     void processSubcriptionResult(TraCIBuffer& buf);
 
     void subscribeToTrafficLightVariables(std::string tlId);
@@ -103,6 +103,9 @@ void TraCIScenarioManagerForker::startServer()
     commandLine = replace(commandLine, "$configFile", configFile);
     commandLine = replace(commandLine, "$seed", seed);
     commandLine = replace(commandLine, "$port", port);
+    // path of the Unix domain socket to connect to, if host is given as "unix:<path>"
+    const std::string unixPrefix = "unix:";
+    commandLine = replace(commandLine, "$socketPath", host.compare(0, unixPrefix.size(), unixPrefix) == 0 ? host.substr(unixPrefix.size()) : "");
 
     server = new TraCILauncher(commandLine);
 }
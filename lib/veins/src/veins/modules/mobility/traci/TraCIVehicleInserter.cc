@@ -129,7 +129,7 @@ void TraCIVehicleInserter::receiveSignal(cComponent* source, simsignal_t signalI
                     routeIds.push_back(routeId);
                 }
             }
-            for (int i = manager->getManagedHosts().size() + queuedVehicles.size(); i < numVehicles; i++) {
+            for (int i = manager->getManagedHostCount() + queuedVehicles.size(); i < numVehicles; i++) {
                 insertNewVehicle();
             }
         }
@@ -48,6 +48,20 @@ void Obstacle::setShape(Coords shape)
         bboxP2.x = std::max(i->x, bboxP2.x);
         bboxP2.y = std::max(i->y, bboxP2.y);
     }
+
+    edgeFromX.clear();
+    edgeFromY.clear();
+    edgeVecX.clear();
+    edgeVecY.clear();
+    if (coords.empty()) return;
+    Coords::const_iterator i = coords.begin();
+    Coords::const_iterator j = (coords.rbegin() + 1).base();
+    for (; i != coords.end(); j = i++) {
+        edgeFromX.push_back(i->x);
+        edgeFromY.push_back(i->y);
+        edgeVecX.push_back(j->x - i->x);
+        edgeVecY.push_back(j->y - i->y);
+    }
 }
 
 const Obstacle::Coords& Obstacle::getShape() const
@@ -83,45 +97,41 @@ bool Obstacle::containsPoint(Coord point) const
     return isInside;
 }
 
-namespace {
-
-double segmentsIntersectAt(const Coord& p1From, const Coord& p1To, const Coord& p2From, const Coord& p2To)
-{
-    double p1x = p1To.x - p1From.x;
-    double p1y = p1To.y - p1From.y;
-    double p2x = p2To.x - p2From.x;
-    double p2y = p2To.y - p2From.y;
-    double p1p2x = p1From.x - p2From.x;
-    double p1p2y = p1From.y - p2From.y;
-    double D = (p1x * p2y - p1y * p2x);
-
-    double p1Frac = (p2x * p1p2y - p2y * p1p2x) / D;
-    if (p1Frac < 0 || p1Frac > 1) return -1;
-
-    double p2Frac = (p1x * p1p2y - p1y * p1p2x) / D;
-    if (p2Frac < 0 || p2Frac > 1) return -1;
-
-    return p1Frac;
-}
-} // namespace
-
 std::vector<double> Obstacle::getIntersections(const Coord& senderPos, const Coord& receiverPos) const
 {
     std::vector<double> intersectAt;
-    const Obstacle::Coords& shape = getShape();
-    Obstacle::Coords::const_iterator i = shape.begin();
-    Obstacle::Coords::const_iterator j = (shape.rbegin() + 1).base();
-    for (; i != shape.end(); j = i++) {
-        const Coord& c1 = *i;
-        const Coord& c2 = *j;
+    getIntersections(senderPos, receiverPos, intersectAt);
+    return intersectAt;
+}
 
-        double i = segmentsIntersectAt(senderPos, receiverPos, c1, c2);
-        if (i != -1) {
-            intersectAt.push_back(i);
-        }
+void Obstacle::getIntersections(const Coord& senderPos, const Coord& receiverPos, std::vector<double>& intersectAt) const
+{
+    const size_t numEdges = edgeFromX.size();
+    const double* fromX = edgeFromX.data();
+    const double* fromY = edgeFromY.data();
+    const double* vecX = edgeVecX.data();
+    const double* vecY = edgeVecY.data();
+    const double senderX = senderPos.x;
+    const double senderY = senderPos.y;
+    const double p1x = receiverPos.x - senderX;
+    const double p1y = receiverPos.y - senderY;
+
+    // test all edges in one branch-free loop, marking non-intersecting edges with -1
+    intersectAt.resize(numEdges);
+    double* out = intersectAt.data();
+    for (size_t k = 0; k < numEdges; ++k) {
+        const double p1p2x = senderX - fromX[k];
+        const double p1p2y = senderY - fromY[k];
+        const double D = (p1x * vecY[k] - p1y * vecX[k]);
+        const double p1Frac = (vecX[k] * p1p2y - vecY[k] * p1p2x) / D;
+        const double p2Frac = (p1x * p1p2y - p1y * p1p2x) / D;
+        const bool miss = (p1Frac < 0) | (p1Frac > 1) | (p2Frac < 0) | (p2Frac > 1);
+        out[k] = miss ? -1 : p1Frac;
     }
+
+    // compact and sort
+    intersectAt.erase(std::remove(intersectAt.begin(), intersectAt.end(), -1), intersectAt.end());
     std::sort(intersectAt.begin(), intersectAt.end());
-    return intersectAt;
 }
 
 std::string Obstacle::getType() const
@@ -56,6 +56,13 @@ public:
      */
     std::vector<double> getIntersections(const Coord& senderPos, const Coord& receiverPos) const;
 
+    /**
+     * Same as getIntersections(const Coord&, const Coord&), but writes the (sorted) points to a caller-provided buffer.
+     *
+     * The buffer is overwritten. Reusing the same buffer across calls avoids allocations.
+     */
+    void getIntersections(const Coord& senderPos, const Coord& receiverPos, std::vector<double>& intersectAt) const;
+
     AnnotationManager::Annotation* visualRepresentation;
 
 protected:
@@ -66,6 +73,12 @@ protected:
     Coords coords;
     Coord bboxP1;
     Coord bboxP2;
+
+    // edges of the shape in struct-of-arrays layout (edge i runs from (edgeFromX[i], edgeFromY[i]) along (edgeVecX[i], edgeVecY[i])), so intersection tests can be vectorized
+    std::vector<double> edgeFromX;
+    std::vector<double> edgeFromY;
+    std::vector<double> edgeVecX;
+    std::vector<double> edgeVecY;
 };
 
 } // namespace veins
@@ -0,0 +1,272 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#include "veins/modules/obstacle/ObstacleAttenuationMap.h"
+
+using veins::Coord;
+using veins::ObstacleAttenuationMap;
+
+constexpr double ObstacleAttenuationMap::dbPerStep;
+constexpr uint8_t ObstacleAttenuationMap::blockedStep;
+
+struct ObstacleAttenuationMap::Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t numCols;
+    uint32_t numRows;
+    uint32_t numEntries;
+    uint64_t fingerprint;
+    double cellSize;
+    double dbPerStep;
+};
+
+namespace {
+
+const char fileMagic[8] = {'V', 'E', 'I', 'N', 'S', 'O', 'A', 'M'};
+const uint32_t fileVersion = 2;
+
+/**
+ * number of cells of an upper triangular matrix (without diagonal) of size n x n
+ */
+size_t triangleSize(size_t n)
+{
+    return n * (n - 1) / 2;
+}
+
+/**
+ * position of element (i, j) with i < j in the row-major upper triangle of an n x n matrix (without diagonal)
+ */
+size_t triangleIndex(size_t i, size_t j, size_t n)
+{
+    return i * n - i * (i + 1) / 2 + (j - i - 1);
+}
+
+uint8_t quantize(double factor)
+{
+    if (!(factor > 0)) return ObstacleAttenuationMap::blockedStep;
+    const double db = -10.0 * std::log10(factor);
+    const double step = std::round(std::max(0.0, db) / ObstacleAttenuationMap::dbPerStep);
+    return static_cast<uint8_t>(std::min(step, static_cast<double>(ObstacleAttenuationMap::blockedStep)));
+}
+
+} // anonymous namespace
+
+ObstacleAttenuationMap::ObstacleAttenuationMap()
+{
+    for (size_t i = 0; i < stepFactors.size(); ++i) {
+        stepFactors[i] = std::pow(10.0, -(i * dbPerStep) / 10.0);
+    }
+    stepFactors[blockedStep] = 0;
+}
+
+ObstacleAttenuationMap::~ObstacleAttenuationMap()
+{
+    unload();
+}
+
+std::vector<Coord> ObstacleAttenuationMap::samplePolylines(const std::vector<std::vector<Coord>>& polylines, double spacing)
+{
+    ASSERT(spacing > 0);
+    std::vector<Coord> samples;
+    for (const auto& polyline : polylines) {
+        if (polyline.empty()) continue;
+        samples.push_back(polyline.front());
+        for (size_t i = 1; i < polyline.size(); ++i) {
+            const Coord& from = polyline[i - 1];
+            const Coord& to = polyline[i];
+            const size_t numSteps = static_cast<size_t>(std::ceil(from.distance(to) / spacing));
+            for (size_t step = 1; step <= numSteps; ++step) {
+                samples.push_back(from + (to - from) * (double(step) / numSteps));
+            }
+        }
+    }
+    return samples;
+}
+
+void ObstacleAttenuationMap::create(const std::string& fileName, uint64_t fingerprint, const std::vector<Coord>& roadPositions, double scenarioX, double scenarioY, double cellSize, size_t maxEntries, AttenuationFunction calculateAttenuation)
+{
+    ASSERT(scenarioX > 0);
+    ASSERT(scenarioY > 0);
+    ASSERT(cellSize > 0);
+    const uint32_t numCols = static_cast<uint32_t>(std::ceil(scenarioX / cellSize));
+    const uint32_t numRows = static_cast<uint32_t>(std::ceil(scenarioY / cellSize));
+
+    // phase 1: assign table entries to all cells containing a road position (positions outside the playground are ignored)
+    std::vector<int32_t> cellEntries(numCols * numRows, -1);
+    std::vector<Coord> entryPositions;
+    for (const Coord& pos : roadPositions) {
+        if (!(pos.x >= 0) || !(pos.y >= 0)) continue;
+        const size_t col = static_cast<size_t>(pos.x / cellSize);
+        const size_t row = static_cast<size_t>(pos.y / cellSize);
+        if (col >= numCols || row >= numRows) continue;
+        int32_t& entry = cellEntries[col + row * numCols];
+        if (entry >= 0) continue;
+        if (entryPositions.size() >= maxEntries) {
+            throw cRuntimeError("Obstacle attenuation map would need more than %zu road cells of %gm (a table of at least %zu bytes); increase the cell size or the maximum number of positions", maxEntries, cellSize, triangleSize(maxEntries + 1));
+        }
+        entry = static_cast<int32_t>(entryPositions.size());
+        entryPositions.push_back(pos);
+    }
+    const size_t numEntries = entryPositions.size();
+
+    // phase 2: write header, cell lookup, and attenuation matrix (one row at a time)
+    std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw cRuntimeError("Could not open obstacle attenuation map \"%s\" for writing", fileName.c_str());
+    }
+    Header header;
+    std::memcpy(header.magic, fileMagic, sizeof(header.magic));
+    header.version = fileVersion;
+    header.numCols = numCols;
+    header.numRows = numRows;
+    header.numEntries = static_cast<uint32_t>(numEntries);
+    header.fingerprint = fingerprint;
+    header.cellSize = cellSize;
+    header.dbPerStep = dbPerStep;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(cellEntries.data()), cellEntries.size() * sizeof(int32_t));
+
+    std::vector<uint8_t> row;
+    row.reserve(numEntries);
+    for (size_t i = 0; i < numEntries; ++i) {
+        row.clear();
+        for (size_t j = i + 1; j < numEntries; ++j) {
+            row.push_back(quantize(calculateAttenuation(entryPositions[i], entryPositions[j])));
+        }
+        out.write(reinterpret_cast<const char*>(row.data()), row.size());
+    }
+    if (!out) {
+        throw cRuntimeError("Could not write obstacle attenuation map \"%s\"", fileName.c_str());
+    }
+}
+
+bool ObstacleAttenuationMap::load(const std::string& fileName, uint64_t fingerprint)
+{
+    unload();
+    if (!mapFile(fileName)) return false;
+
+    const Header* header = reinterpret_cast<const Header*>(data);
+    bool valid = (dataSize >= sizeof(Header));
+    valid = valid && (std::memcmp(header->magic, fileMagic, sizeof(header->magic)) == 0);
+    valid = valid && (header->version == fileVersion);
+    valid = valid && (header->fingerprint == fingerprint);
+    valid = valid && (header->dbPerStep == dbPerStep);
+    valid = valid && (dataSize == sizeof(Header) + size_t(header->numCols) * header->numRows * sizeof(int32_t) + triangleSize(header->numEntries));
+    if (!valid) {
+        unload();
+        return false;
+    }
+
+    cellSize = header->cellSize;
+    numCols = header->numCols;
+    numRows = header->numRows;
+    numEntries = header->numEntries;
+    cellEntries = reinterpret_cast<const int32_t*>(data + sizeof(Header));
+    steps = data + sizeof(Header) + size_t(numCols) * numRows * sizeof(int32_t);
+    return true;
+}
+
+#if !defined(_WIN32)
+
+bool ObstacleAttenuationMap::mapFile(const std::string& fileName)
+{
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    void* mapped = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) return false;
+    data = static_cast<const uint8_t*>(mapped);
+    dataSize = st.st_size;
+    return true;
+}
+
+void ObstacleAttenuationMap::unload()
+{
+    if (data) ::munmap(const_cast<uint8_t*>(data), dataSize);
+    data = nullptr;
+    dataSize = 0;
+    cellEntries = nullptr;
+    steps = nullptr;
+    numEntries = 0;
+}
+
+#else
+
+bool ObstacleAttenuationMap::mapFile(const std::string& fileName)
+{
+    std::ifstream in(fileName, std::ios::binary);
+    if (!in) return false;
+    buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    if (buffer.empty()) return false;
+    data = buffer.data();
+    dataSize = buffer.size();
+    return true;
+}
+
+void ObstacleAttenuationMap::unload()
+{
+    buffer.clear();
+    data = nullptr;
+    dataSize = 0;
+    cellEntries = nullptr;
+    steps = nullptr;
+    numEntries = 0;
+}
+
+#endif
+
+int32_t ObstacleAttenuationMap::entryAt(const Coord& pos) const
+{
+    if (pos.x < 0 || pos.y < 0) return -1;
+    const size_t col = static_cast<size_t>(pos.x / cellSize);
+    const size_t row = static_cast<size_t>(pos.y / cellSize);
+    if (col >= numCols || row >= numRows) return -1;
+    return cellEntries[col + row * numCols];
+}
+
+bool ObstacleAttenuationMap::lookup(const Coord& senderPos, const Coord& receiverPos, double& factor) const
+{
+    if (!isLoaded()) return false;
+    int32_t i = entryAt(senderPos);
+    int32_t j = entryAt(receiverPos);
+    if (i < 0 || j < 0 || i == j) return false;
+    if (i > j) std::swap(i, j);
+    factor = stepFactors[steps[triangleIndex(i, j, numEntries)]];
+    return true;
+}
@@ -0,0 +1,130 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "veins/veins.h"
+
+#include "veins/base/utils/Coord.h"
+
+namespace veins {
+
+/**
+ * Precomputed table of obstacle attenuation between rasterized road positions.
+ *
+ * The playground is divided into square cells.
+ * Every cell that contains a road position (e.g., a point sampled along a lane) gets an entry, located at the first such position.
+ * For each unordered pair of entries, the attenuation between their positions is stored, quantized to steps of dbPerStep dB.
+ * The largest representable value marks a (practically) blocked link.
+ *
+ * The table is written to a file once and memory-mapped for lookups, so later runs with the same obstacles and roads can reuse it.
+ * A fingerprint of the obstacles and roads is stored in the file to detect stale tables.
+ *
+ * Only valid for static obstacles.
+ * Lookups are approximate: positions are snapped to the entry of their cell.
+ */
+class VEINS_API ObstacleAttenuationMap {
+public:
+    /**
+     * returns the multiplicative attenuation factor between two positions
+     */
+    using AttenuationFunction = std::function<double(const Coord&, const Coord&)>;
+
+    static constexpr double dbPerStep = 0.5; /**< quantization of stored attenuation values */
+    static constexpr uint8_t blockedStep = 255; /**< stored value for links attenuated by at least blockedStep * dbPerStep dB */
+
+    ObstacleAttenuationMap();
+    ~ObstacleAttenuationMap();
+    ObstacleAttenuationMap(const ObstacleAttenuationMap&) = delete;
+    ObstacleAttenuationMap& operator=(const ObstacleAttenuationMap&) = delete;
+
+    /**
+     * return points spaced at most spacing apart along each of the given polylines (e.g., lane shapes), including their end points
+     */
+    static std::vector<Coord> samplePolylines(const std::vector<std::vector<Coord>>& polylines, double spacing);
+
+    /**
+     * compute the table between the given road positions and store it in fileName, overwriting any existing file.
+     *
+     * Throws a cRuntimeError (before computing anything) if the road positions cover more than maxEntries cells.
+     */
+    static void create(const std::string& fileName, uint64_t fingerprint, const std::vector<Coord>& roadPositions, double scenarioX, double scenarioY, double cellSize, size_t maxEntries, AttenuationFunction calculateAttenuation);
+
+    /**
+     * map a table stored in fileName.
+     *
+     * @return false if the file does not exist, is malformed, or was created for a different fingerprint
+     */
+    bool load(const std::string& fileName, uint64_t fingerprint);
+
+    /**
+     * unmap any currently loaded table
+     */
+    void unload();
+
+    bool isLoaded() const
+    {
+        return data != nullptr;
+    }
+
+    /**
+     * look up the attenuation factor between two positions.
+     *
+     * @return false if no table entry covers this pair (e.g., a position is off the road or both are in the same cell); the caller has to compute the factor itself
+     */
+    bool lookup(const Coord& senderPos, const Coord& receiverPos, double& factor) const;
+
+    /**
+     * number of road cells that have an entry in the table
+     */
+    size_t getNumEntries() const
+    {
+        return numEntries;
+    }
+
+private:
+    struct Header;
+
+    bool mapFile(const std::string& fileName);
+    int32_t entryAt(const Coord& pos) const;
+
+    const uint8_t* data = nullptr; /**< start of the mapped file */
+    size_t dataSize = 0;
+    const int32_t* cellEntries = nullptr; /**< entry index of each cell (or -1), row-major */
+    const uint8_t* steps = nullptr; /**< upper triangle of the quantized attenuation matrix, row-major */
+    double cellSize = 0;
+    uint32_t numCols = 0;
+    uint32_t numRows = 0;
+    size_t numEntries = 0;
+    std::array<double, 256> stepFactors; /**< multiplicative factor for each quantization step */
+#if defined(_WIN32)
+    std::vector<uint8_t> buffer; /**< file contents (no mmap on this platform) */
+#endif
+};
+
+} // namespace veins
@@ -23,9 +23,11 @@
 #include <sstream>
 #include <map>
 #include <set>
+#include <cstdint>
 
 #include "veins/modules/obstacle/ObstacleControl.h"
 #include "veins/base/modules/BaseWorldUtility.h"
+#include "veins/modules/utility/Profiler.h"
 
 using veins::ObstacleControl;
 
@@ -33,7 +35,7 @@ Define_Module(veins::ObstacleControl);
 
 namespace {
 
-veins::BBoxLookup rebuildBBoxLookup(const std::vector<std::unique_ptr<veins::Obstacle>>& obstacleOwner, int gridCellSize = 250)
+veins::BBoxLookup rebuildBBoxLookup(const std::vector<std::unique_ptr<veins::Obstacle>>& obstacleOwner, int gridCellSize)
 {
     std::vector<veins::Obstacle*> obstaclePointers;
     obstaclePointers.reserve(obstacleOwner.size());
@@ -43,6 +45,36 @@ veins::BBoxLookup rebuildBBoxLookup(const std::vector<std::unique_ptr<veins::Obs
     return veins::BBoxLookup(obstaclePointers, bboxFunction, playgroundSize->x, playgroundSize->y, gridCellSize);
 }
 
+/**
+ * incremental FNV-1a hash to identify a set of obstacles
+ */
+class Fingerprint {
+public:
+    void add(const void* data, size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+    void add(double value)
+    {
+        add(&value, sizeof(value));
+    }
+    void add(const std::string& value)
+    {
+        add(value.data(), value.size() + 1);
+    }
+    uint64_t get() const
+    {
+        return hash;
+    }
+
+private:
+    uint64_t hash = 14695981039346656037ULL;
+};
+
 } // anonymous namespace
 
 ObstacleControl::~ObstacleControl()
@@ -64,6 +96,17 @@ void ObstacleControl::initialize(int stage)
         if (gridCellSize < 1) {
             throw cRuntimeError("gridCellSize was %d, but must be a positive integer number", gridCellSize);
         }
+        attenuationMapFile = par("attenuationMapFile").stdstringValue();
+        attenuationMapCellSize = par("attenuationMapCellSize");
+        if (attenuationMapCellSize <= 0) {
+            throw cRuntimeError("attenuationMapCellSize was %f, but must be positive", attenuationMapCellSize);
+        }
+        const int maxPositions = par("attenuationMapMaxPositions");
+        if (maxPositions < 1) {
+            throw cRuntimeError("attenuationMapMaxPositions was %d, but must be a positive integer number", maxPositions);
+        }
+        attenuationMapMaxPositions = maxPositions;
+        attenuationMap.unload();
 
         addFromXml(obstaclesXml);
     }
@@ -71,6 +114,7 @@ void ObstacleControl::initialize(int stage)
 
 void ObstacleControl::finish()
 {
+    attenuationMap.unload();
     obstacleOwner.clear();
 }
 
@@ -162,10 +206,11 @@ void ObstacleControl::add(Obstacle obstacle)
     obstacleOwner.emplace_back(o);
 
     // visualize using AnnotationManager
-    if (annotations) o->visualRepresentation = annotations->drawPolygon(o->getShape(), "red", annotationGroup);
+    if (!headless && annotations) o->visualRepresentation = annotations->drawPolygon(o->getShape(), "red", annotationGroup);
 
     cacheEntries.clear();
     isBboxLookupDirty = true;
+    discardAttenuationMap();
 }
 
 void ObstacleControl::erase(const Obstacle* obstacle)
@@ -181,6 +226,7 @@ void ObstacleControl::erase(const Obstacle* obstacle)
 
     cacheEntries.clear();
     isBboxLookupDirty = true;
+    discardAttenuationMap();
 }
 
 std::vector<std::pair<veins::Obstacle*, std::vector<double>>> ObstacleControl::getIntersections(const Coord& senderPos, const Coord& receiverPos) const
@@ -189,16 +235,12 @@ std::vector<std::pair<veins::Obstacle*, std::vector<double>>> ObstacleControl::g
 
     // rebuild bounding box lookup structure if dirty (new obstacles added recently)
     if (isBboxLookupDirty) {
-        bboxLookup = rebuildBBoxLookup(obstacleOwner);
+        bboxLookup = rebuildBBoxLookup(obstacleOwner, gridCellSize);
         isBboxLookupDirty = false;
     }
 
     auto candidateObstacles = bboxLookup.findOverlapping({senderPos.x, senderPos.y}, {receiverPos.x, receiverPos.y});
 
-    // remove duplicates
-    sort(candidateObstacles.begin(), candidateObstacles.end());
-    candidateObstacles.erase(unique(candidateObstacles.begin(), candidateObstacles.end()), candidateObstacles.end());
-
     for (Obstacle* o : candidateObstacles) {
         // if obstacles has neither borders nor matter: bail.
         if (o->getShape().size() < 2) continue;
@@ -221,6 +263,14 @@ double ObstacleControl::calculateAttenuation(const Coord& senderPos, const Coord
         throw cRuntimeError("Unable to use SimpleObstacleShadowing: No obstacles have been added");
     }
 
+    // use precomputed table, if built and the positions are covered by it
+    {
+        double factor;
+        if (attenuationMap.lookup(senderPos, receiverPos, factor)) {
+            return factor;
+        }
+    }
+
     // return cached result, if available
     CacheKey cacheKey(senderPos, receiverPos);
     CacheEntries::const_iterator cacheEntryIter = cacheEntries.find(cacheKey);
@@ -228,34 +278,89 @@ double ObstacleControl::calculateAttenuation(const Coord& senderPos, const Coord
         return cacheEntryIter->second;
     }
 
-    // get intersections
-    auto intersections = getIntersections(senderPos, receiverPos);
+    double factor = computeAttenuation(senderPos, receiverPos);
+
+    // cache result
+    if (cacheEntries.size() >= 1000) cacheEntries.clear();
+    cacheEntries[cacheKey] = factor;
+
+    return factor;
+}
+
+void ObstacleControl::prepareConcurrentAttenuation() const
+{
+    Enter_Method_Silent();
+
+    if ((perCut.size() == 0) || (perMeter.size() == 0)) {
+        throw cRuntimeError("Unable to use SimpleObstacleShadowing: No obstacle types have been configured");
+    }
+    if (obstacleOwner.size() == 0) {
+        throw cRuntimeError("Unable to use SimpleObstacleShadowing: No obstacles have been added");
+    }
+
+    if (isBboxLookupDirty) {
+        bboxLookup = rebuildBBoxLookup(obstacleOwner, gridCellSize);
+        isBboxLookupDirty = false;
+    }
+}
+
+double ObstacleControl::calculateAttenuationConcurrently(const Coord& senderPos, const Coord& receiverPos) const
+{
+    ASSERT(!isBboxLookupDirty);
+
+    // same as calculateAttenuation(), except for the (shared) cache, which only holds results of computeAttenuation() anyway
+    double factor;
+    if (attenuationMap.lookup(senderPos, receiverPos, factor)) {
+        return factor;
+    }
+    return computeAttenuation(senderPos, receiverPos);
+}
+
+double ObstacleControl::computeAttenuation(const Coord& senderPos, const Coord& receiverPos) const
+{
+    // profile only this (cache and table miss) path, the lookups are too cheap to measure
+    VEINS_PROFILE_SCOPE("ObstacleControl::computeAttenuation");
+
+    // scratch buffers, reused across calls to avoid allocations
+    static thread_local std::vector<Obstacle*> candidateObstacles;
+    static thread_local std::vector<double> intersectAt;
+
+    // rebuild bounding box lookup structure if dirty (new obstacles added recently)
+    if (isBboxLookupDirty) {
+        bboxLookup = rebuildBBoxLookup(obstacleOwner, gridCellSize);
+        isBboxLookupDirty = false;
+    }
+
+    bboxLookup.findOverlapping({senderPos.x, senderPos.y}, {receiverPos.x, receiverPos.y}, candidateObstacles);
 
     double factor = 1;
-    for (auto i = intersections.begin(); i != intersections.end(); ++i) {
-        auto o = i->first;
-        auto intersectAt = i->second;
+    for (Obstacle* o : candidateObstacles) {
+        // if obstacles has neither borders nor matter: bail.
+        if (o->getShape().size() < 2) continue;
+
+        o->getIntersections(senderPos, receiverPos, intersectAt);
 
         // if beam interacts with neither borders nor matter: bail.
         bool senderInside = o->containsPoint(senderPos);
         bool receiverInside = o->containsPoint(receiverPos);
         if ((intersectAt.size() == 0) && !senderInside && !receiverInside) continue;
 
-        // remember number of cuts before messing with intersection points
+        // remember number of cuts
         double numCuts = intersectAt.size();
 
-        // for distance calculation, make sure every other pair of points marks transition through matter and void, respectively.
-        if (senderInside) intersectAt.insert(intersectAt.begin(), 0);
-        if (receiverInside) intersectAt.push_back(1);
-        ASSERT((intersectAt.size() % 2) == 0);
+        // every other intersection point marks transition through matter and void, respectively.
+        ASSERT(((intersectAt.size() + senderInside + receiverInside) % 2) == 0);
 
         // sum up distances in matter.
         double fractionInObstacle = 0;
-        for (auto i = intersectAt.begin(); i != intersectAt.end();) {
-            double p1 = *(i++);
-            double p2 = *(i++);
-            fractionInObstacle += (p2 - p1);
+        bool inside = senderInside;
+        double previous = 0;
+        for (double p : intersectAt) {
+            if (inside) fractionInObstacle += (p - previous);
+            inside = !inside;
+            previous = p;
         }
+        if (inside) fractionInObstacle += (1 - previous);
 
         // calculate attenuation
         double totalDistance = senderPos.distance(receiverPos);
@@ -266,13 +371,62 @@ double ObstacleControl::calculateAttenuation(const Coord& senderPos, const Coord
         if (factor < 1e-30) break;
     }
 
-    // cache result
-    if (cacheEntries.size() >= 1000) cacheEntries.clear();
-    cacheEntries[cacheKey] = factor;
-
     return factor;
 }
 
+void ObstacleControl::buildAttenuationMap(const std::vector<std::vector<Coord>>& laneShapes)
+{
+    Enter_Method_Silent();
+
+    if (attenuationMapFile.empty()) return;
+    if (obstacleOwner.empty()) {
+        EV_WARN << "Not precomputing an obstacle attenuation map: no obstacles have been added" << endl;
+        return;
+    }
+
+    auto playgroundSize = FindModule<BaseWorldUtility*>::findGlobalModule()->getPgs();
+    // sample lanes densely enough that every cell they cross gets a position
+    std::vector<Coord> roadPositions = ObstacleAttenuationMap::samplePolylines(laneShapes, attenuationMapCellSize / 2);
+
+    Fingerprint fingerprint;
+    fingerprint.add(playgroundSize->x);
+    fingerprint.add(playgroundSize->y);
+    fingerprint.add(attenuationMapCellSize);
+    for (const auto& c : roadPositions) {
+        fingerprint.add(c.x);
+        fingerprint.add(c.y);
+    }
+    for (const auto& o : obstacleOwner) {
+        fingerprint.add(o->getId());
+        fingerprint.add(o->getAttenuationPerCut());
+        fingerprint.add(o->getAttenuationPerMeter());
+        for (const auto& c : o->getShape()) {
+            fingerprint.add(c.x);
+            fingerprint.add(c.y);
+        }
+    }
+
+    if (attenuationMap.load(attenuationMapFile, fingerprint.get())) {
+        EV_INFO << "Using precomputed obstacle attenuation map from \"" << attenuationMapFile << "\" (" << attenuationMap.getNumEntries() << " positions)" << endl;
+        return;
+    }
+
+    EV_INFO << "Precomputing obstacle attenuation map for " << obstacleOwner.size() << " obstacles and " << laneShapes.size() << " lanes, storing it in \"" << attenuationMapFile << "\"" << endl;
+    auto calculate = [this](const Coord& senderPos, const Coord& receiverPos) { return computeAttenuation(senderPos, receiverPos); };
+    ObstacleAttenuationMap::create(attenuationMapFile, fingerprint.get(), roadPositions, playgroundSize->x, playgroundSize->y, attenuationMapCellSize, attenuationMapMaxPositions, calculate);
+    if (!attenuationMap.load(attenuationMapFile, fingerprint.get())) {
+        throw cRuntimeError("Could not load freshly created obstacle attenuation map \"%s\"", attenuationMapFile.c_str());
+    }
+    EV_INFO << "Precomputed obstacle attenuation map has " << attenuationMap.getNumEntries() << " positions" << endl;
+}
+
+void ObstacleControl::discardAttenuationMap()
+{
+    if (!attenuationMap.isLoaded()) return;
+    EV_WARN << "Obstacles changed after the obstacle attenuation map was built, discarding it" << endl;
+    attenuationMap.unload();
+}
+
 double ObstacleControl::getAttenuationPerCut(std::string type)
 {
     if (perCut.find(type) != perCut.end())
@@ -28,6 +28,7 @@
 
 #include "veins/base/utils/Coord.h"
 #include "veins/modules/obstacle/Obstacle.h"
+#include "veins/modules/obstacle/ObstacleAttenuationMap.h"
 #include "veins/modules/world/annotations/AnnotationManager.h"
 #include "veins/modules/utility/BBoxLookup.h"
 
@@ -70,7 +71,43 @@ public:
      */
     double calculateAttenuation(const Coord& senderPos, const Coord& receiverPos) const;
 
+    /**
+     * whether a precomputed attenuation table should be built (i.e., attenuationMapFile is set)
+     */
+    bool usesAttenuationMap() const
+    {
+        return !attenuationMapFile.empty();
+    }
+
+    /**
+     * load (or, if missing or stale, create) the precomputed attenuation table between positions along the given lanes for the current set of obstacles.
+     *
+     * To be called once all static obstacles have been added (e.g., at startup).
+     * Adding or erasing obstacles afterwards discards the table.
+     */
+    void buildAttenuationMap(const std::vector<std::vector<Coord>>& laneShapes);
+
+    /**
+     * bring lazily built lookup structures up to date, so calculateAttenuationConcurrently() can be used
+     */
+    void prepareConcurrentAttenuation() const;
+
+    /**
+     * same result as calculateAttenuation(), but safe to call from multiple threads at once (after prepareConcurrentAttenuation() and as long as no obstacles change)
+     */
+    double calculateAttenuationConcurrently(const Coord& senderPos, const Coord& receiverPos) const;
+
 protected:
+    /**
+     * calculate additional attenuation by obstacles without consulting any cache or precomputed table
+     */
+    double computeAttenuation(const Coord& senderPos, const Coord& receiverPos) const;
+
+    /**
+     * discard the precomputed attenuation table, as it no longer matches the obstacles
+     */
+    void discardAttenuationMap();
+
     struct CacheKey {
         const Coord senderPos;
         const Coord receiverPos;
@@ -99,6 +136,9 @@ protected:
 
     cXMLElement* obstaclesXml; /**< obstacles to add at startup */
     int gridCellSize = 250; /**< size of square grid tiles for obstacle store */
+    std::string attenuationMapFile; /**< file to store precomputed attenuation table in (empty if disabled) */
+    double attenuationMapCellSize; /**< size of square grid tiles for precomputed attenuation table */
+    size_t attenuationMapMaxPositions; /**< maximum number of road cells in the precomputed attenuation table */
 
     std::vector<std::unique_ptr<Obstacle>> obstacleOwner;
     AnnotationManager* annotations;
@@ -108,6 +148,7 @@ protected:
     mutable CacheEntries cacheEntries;
     mutable BBoxLookup bboxLookup;
     mutable bool isBboxLookupDirty = true;
+    ObstacleAttenuationMap attenuationMap;
 };
 
 class VEINS_API ObstacleControlAccess {
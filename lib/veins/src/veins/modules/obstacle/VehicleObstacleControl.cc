@@ -20,6 +20,7 @@
 // Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 //
 
+#include <algorithm>
 #include <sstream>
 #include <map>
 #include <set>
@@ -31,9 +32,13 @@
 #include "veins/base/modules/BaseMobility.h"
 #include "veins/base/connectionManager/ChannelAccess.h"
 #include "veins/base/toolbox/Signal.h"
+#include "veins/base/modules/BaseWorldUtility.h"
+#include "veins/modules/mobility/traci/TraCIScenarioManager.h"
 
 using veins::MobileHostObstacle;
 using veins::Signal;
+using veins::TraCIScenarioManager;
+using veins::TraCIScenarioManagerAccess;
 using veins::VehicleObstacleControl;
 
 Define_Module(veins::VehicleObstacleControl);
@@ -47,11 +52,57 @@ void VehicleObstacleControl::initialize(int stage)
         if (annotations) {
             vehicleAnnotationGroup = annotations->createGroup("vehicleObstacles");
         }
+
+        useGrid = par("useGrid");
+        if (useGrid) {
+            // without TraCI timesteps, there is no point in time to rebuild the grid at: all vehicles stay in newObstacles
+            auto manager = TraCIScenarioManagerAccess().get();
+            if (manager) {
+                auto playgroundSize = FindModule<BaseWorldUtility*>::findGlobalModule()->getPgs();
+                const double gridCellSize = par("gridCellSize").doubleValue();
+                if (!(gridCellSize > 0)) {
+                    throw cRuntimeError("gridCellSize was %f, but must be positive", gridCellSize);
+                }
+                grid = VehicleObstacleGrid(playgroundSize->x, playgroundSize->y, gridCellSize);
+                traciManager = manager;
+                traciManager->subscribe(TraCIScenarioManager::traciTimestepEndSignal, this);
+            }
+        }
     }
 }
 
 void VehicleObstacleControl::finish()
 {
+    if (traciManager) {
+        traciManager->unsubscribe(TraCIScenarioManager::traciTimestepEndSignal, this);
+        traciManager = nullptr;
+    }
+}
+
+void VehicleObstacleControl::receiveSignal(cComponent* source, simsignal_t signalID, const SimTime& t, cObject* details)
+{
+    if (signalID == TraCIScenarioManager::traciTimestepEndSignal) {
+        rebuildGrid(simTime());
+    }
+}
+
+void VehicleObstacleControl::rebuildGrid(const simtime_t& t)
+{
+    gridObstacles.assign(vehicleObstacles.begin(), vehicleObstacles.end());
+    newObstacles.clear();
+    gridTime = t;
+    gridMaxSpeed = 0;
+
+    // store a square around each vehicle's position that contains its shape (see MobileHostObstacle::getShape) at any orientation
+    std::vector<VehicleObstacleGrid::Box> boxes;
+    boxes.reserve(gridObstacles.size());
+    for (auto o : gridObstacles) {
+        const Coord p = o->getMobility()->getPositionAt(t);
+        const double extent = std::hypot(std::max(std::abs(o->getLength() - o->getHostPositionOffset()), std::abs(o->getHostPositionOffset())), o->getWidth() / 2);
+        boxes.push_back({Coord(p.x - extent, p.y - extent), Coord(p.x + extent, p.y + extent)});
+        gridMaxSpeed = std::max(gridMaxSpeed, o->getMobility()->getCurrentSpeed().length());
+    }
+    grid.rebuild(boxes);
 }
 
 void VehicleObstacleControl::handleMessage(cMessage* msg)
@@ -72,6 +123,7 @@ const MobileHostObstacle* VehicleObstacleControl::add(MobileHostObstacle obstacl
 {
     auto* o = new MobileHostObstacle(obstacle);
     vehicleObstacles.push_back(o);
+    newObstacles.push_back(o);
 
     return o;
 }
@@ -90,6 +142,14 @@ void VehicleObstacleControl::erase(const MobileHostObstacle* obstacle)
         }
     }
     ASSERT(erasedOne);
+    auto newIt = std::find(newObstacles.begin(), newObstacles.end(), obstacle);
+    if (newIt != newObstacles.end()) {
+        newObstacles.erase(newIt);
+    }
+    else {
+        auto gridIt = std::find(gridObstacles.begin(), gridObstacles.end(), obstacle);
+        if (gridIt != gridObstacles.end()) *gridIt = nullptr;
+    }
     delete obstacle;
 }
 
@@ -292,7 +352,7 @@ std::vector<std::pair<double, double>> VehicleObstacleControl::getPotentialObsta
 
     EV << "searching candidates for transmission from " << senderPos.info() << " -> " << receiverPos.info() << " (" << senderPos.distance(receiverPos) << "meters total)" << std::endl;
 
-    if (hasGUI() && annotations) {
+    if (!headless && hasGUI() && annotations) {
         annotations->eraseAll(vehicleAnnotationGroup);
         drawVehicleObstacles(sStart);
         annotations->drawLine(senderPos, receiverPos, "blue", vehicleAnnotationGroup);
@@ -303,7 +363,23 @@ std::vector<std::pair<double, double>> VehicleObstacleControl::getPotentialObsta
     double y1 = std::min(senderPos.y, receiverPos.y);
     double y2 = std::max(senderPos.y, receiverPos.y);
 
-    for (auto o : vehicleObstacles) {
+    // vehicles in the grid may have moved by at most gridMaxSpeed * |sStart - gridTime| since it was built
+    static thread_local std::vector<size_t> gridCandidates;
+    static thread_local std::vector<MobileHostObstacle*> candidates;
+    candidates.clear();
+    if (traciManager) {
+        const double margin = gridMaxSpeed * std::abs(SIMTIME_DBL(sStart - gridTime));
+        grid.findCandidates(senderPos, receiverPos, margin, gridCandidates);
+        for (auto i : gridCandidates) {
+            if (gridObstacles[i]) candidates.push_back(gridObstacles[i]);
+        }
+        candidates.insert(candidates.end(), newObstacles.begin(), newObstacles.end());
+    }
+    else {
+        candidates.assign(vehicleObstacles.begin(), vehicleObstacles.end());
+    }
+
+    for (auto o : candidates) {
         auto obstacleAntennaPositions = o->getInitialAntennaPositions();
         double l = o->getLength();
         double w = o->getWidth();
@@ -354,7 +430,7 @@ std::vector<std::pair<double, double>> VehicleObstacleControl::getPotentialObsta
             }
             EV << "\tgot obstacle in 2d-LOS, " << p1d << " meters away from sender" << std::endl;
             Coord hitPos = senderPos + (receiverPos - senderPos) / senderPos.distance(receiverPos) * p1d;
-            if (hasGUI() && annotations) {
+            if (!headless && hasGUI() && annotations) {
                 annotations->drawLine(senderPos, hitPos, "red", vehicleAnnotationGroup);
             }
         }
@@ -32,6 +32,7 @@
 #include "veins/modules/world/annotations/AnnotationManager.h"
 #include "veins/base/utils/Move.h"
 #include "veins/modules/obstacle/MobileHostObstacle.h"
+#include "veins/modules/obstacle/VehicleObstacleGrid.h"
 
 namespace veins {
 
@@ -43,8 +44,11 @@ class Signal;
  * Each Obstacle is a polygon.
  * Transmissions that cross one of the polygon's lines will have
  * their receive power set to zero.
+ *
+ * If a TraCIScenarioManager is present, vehicle footprints are stored in a grid
+ * that is rebuilt at the end of each TraCI timestep, so links only check vehicles close to them.
  */
-class VEINS_API VehicleObstacleControl : public cSimpleModule {
+class VEINS_API VehicleObstacleControl : public cSimpleModule, public cListener {
 public:
     ~VehicleObstacleControl() override;
     void initialize(int stage) override;
@@ -55,6 +59,7 @@ public:
     void finish() override;
     void handleMessage(cMessage* msg) override;
     void handleSelfMsg(cMessage* msg);
+    void receiveSignal(cComponent* source, simsignal_t signalID, const SimTime& t, cObject* details) override;
 
     const MobileHostObstacle* add(MobileHostObstacle obstacle);
     void erase(const MobileHostObstacle* obstacle);
@@ -95,6 +100,19 @@ protected:
     VehicleObstacles vehicleObstacles;
     AnnotationManager::Group* vehicleAnnotationGroup;
     void drawVehicleObstacles(const simtime_t& t) const;
+
+    /**
+     * store the footprints of all vehicles at time t in the grid
+     */
+    void rebuildGrid(const simtime_t& t);
+
+    cModule* traciManager = nullptr; /**< source of the timestep signal the grid is rebuilt on (if any) */
+    bool useGrid;
+    VehicleObstacleGrid grid;
+    std::vector<MobileHostObstacle*> gridObstacles; /**< vehicles stored in the grid (by index); nullptr if erased since */
+    std::vector<MobileHostObstacle*> newObstacles; /**< vehicles added since the grid was rebuilt (always checked) */
+    simtime_t gridTime; /**< time the stored footprints refer to */
+    double gridMaxSpeed = 0; /**< highest speed of any vehicle in the grid (for bounding the movement since gridTime) */
 };
 
 class VEINS_API VehicleObstacleControlAccess {
@@ -0,0 +1,119 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "veins/modules/obstacle/VehicleObstacleGrid.h"
+
+using veins::Coord;
+using veins::VehicleObstacleGrid;
+
+namespace {
+
+// guards against rounding errors when interpolating along the line
+const double marginEpsilon = 1e-6;
+
+} // anonymous namespace
+
+VehicleObstacleGrid::VehicleObstacleGrid(double scenarioX, double scenarioY, double cellSize)
+    : cellSize(cellSize)
+    , numCols(std::max<size_t>(1, static_cast<size_t>(std::ceil(scenarioX / cellSize))))
+    , numRows(std::max<size_t>(1, static_cast<size_t>(std::ceil(scenarioY / cellSize))))
+{
+    ASSERT(cellSize > 0);
+    cellStart.assign(numCols * numRows + 1, 0);
+}
+
+size_t VehicleObstacleGrid::colAt(double x) const
+{
+    if (!(x >= 0)) return 0;
+    return std::min(static_cast<size_t>(x / cellSize), numCols - 1);
+}
+
+size_t VehicleObstacleGrid::rowAt(double y) const
+{
+    if (!(y >= 0)) return 0;
+    return std::min(static_cast<size_t>(y / cellSize), numRows - 1);
+}
+
+void VehicleObstacleGrid::rebuild(const std::vector<Box>& boxes)
+{
+    ASSERT(cellSize > 0);
+    numBoxes = boxes.size();
+
+    // counting sort of box indices into cells: count entries per cell first, then fill
+    std::fill(cellStart.begin(), cellStart.end(), 0);
+    for (const auto& box : boxes) {
+        for (size_t row = rowAt(box.p1.y); row <= rowAt(box.p2.y); ++row) {
+            for (size_t col = colAt(box.p1.x); col <= colAt(box.p2.x); ++col) {
+                ++cellStart[col + row * numCols + 1];
+            }
+        }
+    }
+    for (size_t i = 1; i < cellStart.size(); ++i) {
+        cellStart[i] += cellStart[i - 1];
+    }
+    cellEntries.resize(cellStart.back());
+    std::vector<size_t> fill(cellStart.begin(), cellStart.end() - 1);
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        const auto& box = boxes[i];
+        for (size_t row = rowAt(box.p1.y); row <= rowAt(box.p2.y); ++row) {
+            for (size_t col = colAt(box.p1.x); col <= colAt(box.p2.x); ++col) {
+                cellEntries[fill[col + row * numCols]++] = i;
+            }
+        }
+    }
+}
+
+void VehicleObstacleGrid::findCandidates(const Coord& sender, const Coord& receiver, double margin, std::vector<size_t>& candidates) const
+{
+    candidates.clear();
+    if (numBoxes == 0) return;
+    margin += marginEpsilon;
+
+    const double minX = std::min(sender.x, receiver.x);
+    const double maxX = std::max(sender.x, receiver.x);
+    const bool isVertical = (sender.x == receiver.x);
+    const double slope = isVertical ? 0 : (receiver.y - sender.y) / (receiver.x - sender.x);
+
+    // for each column crossed by the (widened) line, visit the rows the (widened) line covers within this column
+    const double inf = std::numeric_limits<double>::infinity();
+    for (size_t col = colAt(minX - margin); col <= colAt(maxX + margin); ++col) {
+        // border columns also hold everything beyond the playground
+        const double colFrom = (col == 0) ? -inf : col * cellSize;
+        const double colTo = (col == numCols - 1) ? inf : (col + 1) * cellSize;
+        const double from = std::max(colFrom - margin, minX);
+        const double to = std::min(colTo + margin, maxX);
+        double y1 = isVertical ? sender.y : sender.y + (from - sender.x) * slope;
+        double y2 = isVertical ? receiver.y : sender.y + (to - sender.x) * slope;
+        if (y1 > y2) std::swap(y1, y2);
+        for (size_t row = rowAt(y1 - margin); row <= rowAt(y2 + margin); ++row) {
+            const size_t cell = col + row * numCols;
+            candidates.insert(candidates.end(), cellEntries.begin() + cellStart[cell], cellEntries.begin() + cellStart[cell + 1]);
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+}
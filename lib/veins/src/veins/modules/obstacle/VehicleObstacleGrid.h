@@ -0,0 +1,83 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <vector>
+
+#include "veins/veins.h"
+
+#include "veins/base/utils/Coord.h"
+
+namespace veins {
+
+/**
+ * Uniform grid of axis-aligned bounding boxes (e.g., vehicle footprints), rebuilt as a whole whenever the boxes change.
+ *
+ * Boxes are identified by their index in the vector passed to rebuild().
+ * Boxes (partially) outside the playground are stored in the closest border cells.
+ *
+ * Only considers a 2-dimensional plane (x and y coordinates).
+ */
+class VEINS_API VehicleObstacleGrid {
+public:
+    struct Box {
+        Coord p1; /**< corner with the smallest coordinates */
+        Coord p2; /**< corner with the largest coordinates */
+    };
+
+    VehicleObstacleGrid() = default;
+    VehicleObstacleGrid(double scenarioX, double scenarioY, double cellSize);
+
+    /**
+     * replace all stored boxes
+     */
+    void rebuild(const std::vector<Box>& boxes);
+
+    /**
+     * Find all boxes that might be closer than margin to the line from sender to receiver.
+     *
+     * Only walks the cells along the line.
+     * False positives are possible, false negatives are not.
+     *
+     * @param candidates is cleared and filled with the indices of the found boxes, in ascending order and without duplicates
+     */
+    void findCandidates(const Coord& sender, const Coord& receiver, double margin, std::vector<size_t>& candidates) const;
+
+    size_t getNumBoxes() const
+    {
+        return numBoxes;
+    }
+
+private:
+    size_t colAt(double x) const;
+    size_t rowAt(double y) const;
+
+    std::vector<size_t> cellStart; /**< entries of cell i are cellEntries[cellStart[i]] to cellEntries[cellStart[i + 1] - 1] */
+    std::vector<size_t> cellEntries; /**< box indices, ordered by cells */
+    double cellSize = 0;
+    size_t numCols = 0;
+    size_t numRows = 0;
+    size_t numBoxes = 0;
+};
+
+} // namespace veins
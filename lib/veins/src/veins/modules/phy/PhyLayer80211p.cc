@@ -165,7 +165,18 @@ unique_ptr<AnalogueModel> PhyLayer80211p::initializeNakagamiFading(ParameterMap&
     if (constM) {
         m = params["m"].doubleValue();
     }
-    return make_unique<NakagamiFading>(this, constM, m);
+    bool counterBasedRng = false;
+    uint64_t seed = 0;
+    ParameterMap::iterator it = params.find("counterBasedRng");
+    if (it != params.end()) {
+        counterBasedRng = it->second.boolValue();
+    }
+    if (counterBasedRng) {
+        // reproducible per run, like the seeds of the regular RNGs
+        const char* seedSet = cSimulation::getActiveSimulation()->getEnvir()->getConfigEx()->getVariable(CFGVAR_SEEDSET);
+        seed = strtoull(seedSet, nullptr, 10);
+    }
+    return make_unique<NakagamiFading>(this, constM, m, counterBasedRng, seed);
 }
 
 unique_ptr<AnalogueModel> PhyLayer80211p::initializeSimplePathlossModel(ParameterMap& params)
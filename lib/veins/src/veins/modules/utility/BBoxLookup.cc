@@ -21,6 +21,8 @@
 //
 
 #include <cmath>
+#include <cstdint>
+#include <limits>
 
 #include "veins/modules/utility/BBoxLookup.h"
 
@@ -86,6 +88,39 @@ bool intersects(const Ray& ray, const Box& box)
     return (tmin < ray.length) && (tmax > 0);
 }
 
+/**
+ * Per-thread marks to report each obstacle at most once per query.
+ *
+ * An obstacle with index i has already been reported in the current query if stamps[i] == current.
+ * Starting a new query only increments current, so no clearing is needed.
+ */
+struct DedupStamps {
+    std::vector<uint32_t> stamps;
+    uint32_t current = 0;
+
+    void startQuery(size_t numObstacles)
+    {
+        if (stamps.size() < numObstacles) stamps.resize(numObstacles, 0);
+        if (++current == 0) {
+            // wrapped around: forget all marks
+            std::fill(stamps.begin(), stamps.end(), 0);
+            current = 1;
+        }
+    }
+
+    bool isMarked(size_t i) const
+    {
+        return stamps[i] == current;
+    }
+
+    void mark(size_t i)
+    {
+        stamps[i] = current;
+    }
+};
+
+thread_local DedupStamps dedupStamps;
+
 } // anonymous namespace
 
 namespace veins {
@@ -93,6 +128,7 @@ namespace veins {
 BBoxLookup::BBoxLookup(const std::vector<Obstacle*>& obstacles, std::function<BBoxLookup::Box(Obstacle*)> makeBBox, double scenarioX, double scenarioY, int cellSize)
     : bboxes()
     , obstacleLookup()
+    , obstacles(obstacles)
     , bboxCells()
     , cellSize(cellSize)
     , numCols(std::floor(scenarioX / cellSize) + 1)
@@ -106,11 +142,11 @@ BBoxLookup::BBoxLookup(const std::vector<Obstacle*>& obstacles, std::function<BB
     ASSERT(numRows * cellSize >= scenarioY);
     const size_t numCells = numCols * numRows;
     std::vector<std::vector<BBoxLookup::Box>> protoCells(numCells);
-    std::vector<std::vector<Obstacle*>> protoLookup(numCells);
+    std::vector<std::vector<size_t>> protoLookup(numCells);
     // fill protoCells with boundingBoxes
     size_t numEntries = 0;
-    for (const auto obstaclePtr : obstacles) {
-        auto bbox = makeBBox(obstaclePtr);
+    for (size_t obstacleIndex = 0; obstacleIndex < obstacles.size(); ++obstacleIndex) {
+        auto bbox = makeBBox(obstacles[obstacleIndex]);
         const size_t fromCol = std::min(size_t(std::max(0, int(bbox.p1.x / cellSize))), numCols - 1);
         const size_t toCol = std::min(size_t(std::max(0, int(bbox.p2.x / cellSize))), numCols - 1);
         const size_t fromRow = std::min(size_t(std::max(0, int(bbox.p1.y / cellSize))), numRows - 1);
@@ -123,7 +159,7 @@ BBoxLookup::BBoxLookup(const std::vector<Obstacle*>& obstacles, std::function<BB
                 ASSERT(col < numCols);
                 const size_t cellIndex = col + row * numCols;
                 protoCells[cellIndex].push_back(bbox);
-                protoLookup[cellIndex].push_back(obstaclePtr);
+                protoLookup[cellIndex].push_back(obstacleIndex);
                 ++numEntries;
                 ASSERT(protoCells[cellIndex].size() == protoLookup[cellIndex].size());
             }
@@ -161,43 +197,119 @@ BBoxLookup::BBoxLookup(const std::vector<Obstacle*>& obstacles, std::function<BB
 std::vector<Obstacle*> BBoxLookup::findOverlapping(Point sender, Point receiver) const
 {
     std::vector<Obstacle*> overlappingObstacles;
+    findOverlapping(sender, receiver, overlappingObstacles);
+    return overlappingObstacles;
+}
+
+void BBoxLookup::findOverlapping(Point sender, Point receiver, std::vector<Obstacle*>& overlappingObstacles) const
+{
+    overlappingObstacles.clear();
+    dedupStamps.startQuery(obstacles.size());
     const Box bbox{
         {std::min(sender.x, receiver.x), std::min(sender.y, receiver.y)},
         {std::max(sender.x, receiver.x), std::max(sender.y, receiver.y)},
     };
 
-    // determine coordinates for all cells touched by bbox
-    const size_t firstCol = std::min(size_t(std::max(0, int(bbox.p1.x / cellSize))), numCols - 1);
-    const size_t lastCol = std::min(size_t(std::max(0, int(bbox.p2.x / cellSize))), numCols - 1);
-    const size_t firstRow = std::min(size_t(std::max(0, int(bbox.p1.y / cellSize))), numRows - 1);
-    const size_t lastRow = std::min(size_t(std::max(0, int(bbox.p2.y / cellSize))), numRows - 1);
-    ASSERT(lastCol < numCols && lastRow < numRows);
     // precompute transmission ray properties
     const Ray ray = makeRay(sender, receiver);
-    // iterate over cells
-    for (size_t row = firstRow; row <= lastRow; ++row) {
-        for (size_t col = firstCol; col <= lastCol; ++col) {
-            // skip cell if ray does not intersect with the cell.
-            const Box cellBox = {{static_cast<double>(col * cellSize), static_cast<double>(row * cellSize)}, {static_cast<double>((col + 1) * cellSize), static_cast<double>((row + 1) * cellSize)}};
-            if (!intersects(ray, cellBox)) continue;
-            // derive cell for current cell coordinates
-            const size_t cellIndex = col + row * numCols;
-            const BBoxCell& cell = bboxCells.at(cellIndex);
-            // iterate over bboxes in each cell
-            for (size_t bboxIndex = cell.index; bboxIndex < cell.index + cell.count; ++bboxIndex) {
-                const Box& current = bboxes.at(bboxIndex);
-                // check for overlap with bbox (fast rejection)
-                if (current.p2.x < bbox.p1.x) continue;
-                if (current.p1.x > bbox.p2.x) continue;
-                if (current.p2.y < bbox.p1.y) continue;
-                if (current.p1.y > bbox.p2.y) continue;
-                // derive corresponding obstacle
-                if (!intersects(ray, current)) continue;
-                overlappingObstacles.push_back(obstacleLookup.at(bboxIndex));
+
+    // collect all obstacles of a single cell
+    auto visitCell = [&](size_t col, size_t row) {
+        ASSERT(col < numCols && row < numRows);
+        // derive cell for current cell coordinates
+        const size_t cellIndex = col + row * numCols;
+        const BBoxCell& cell = bboxCells[cellIndex];
+        // iterate over bboxes in each cell
+        for (size_t bboxIndex = cell.index; bboxIndex < cell.index + cell.count; ++bboxIndex) {
+            const Box& current = bboxes[bboxIndex];
+            // check for overlap with bbox (fast rejection)
+            if (current.p2.x < bbox.p1.x) continue;
+            if (current.p1.x > bbox.p2.x) continue;
+            if (current.p2.y < bbox.p1.y) continue;
+            if (current.p1.y > bbox.p2.y) continue;
+            // skip obstacles already reported (they are stored in every cell they overlap)
+            const size_t obstacleIndex = obstacleLookup[bboxIndex];
+            if (dedupStamps.isMarked(obstacleIndex)) continue;
+            // derive corresponding obstacle
+            if (!intersects(ray, current)) continue;
+            dedupStamps.mark(obstacleIndex);
+            overlappingObstacles.push_back(obstacles[obstacleIndex]);
+        }
+    };
+
+    const double gridX = static_cast<double>(numCols * cellSize);
+    const double gridY = static_cast<double>(numRows * cellSize);
+    const bool insideGrid = (bbox.p1.x >= 0) && (bbox.p1.y >= 0) && (bbox.p2.x < gridX) && (bbox.p2.y < gridY);
+
+    if (!insideGrid) {
+        // obstacles outside the grid are stored in its border cells, so check all cells touched by bbox
+        const size_t firstCol = std::min(size_t(std::max(0, int(bbox.p1.x / cellSize))), numCols - 1);
+        const size_t lastCol = std::min(size_t(std::max(0, int(bbox.p2.x / cellSize))), numCols - 1);
+        const size_t firstRow = std::min(size_t(std::max(0, int(bbox.p1.y / cellSize))), numRows - 1);
+        const size_t lastRow = std::min(size_t(std::max(0, int(bbox.p2.y / cellSize))), numRows - 1);
+        for (size_t row = firstRow; row <= lastRow; ++row) {
+            for (size_t col = firstCol; col <= lastCol; ++col) {
+                // skip cell if ray does not intersect with the cell.
+                const Box cellBox = {{static_cast<double>(col * cellSize), static_cast<double>(row * cellSize)}, {static_cast<double>((col + 1) * cellSize), static_cast<double>((row + 1) * cellSize)}};
+                if (!intersects(ray, cellBox)) continue;
+                visitCell(col, row);
             }
         }
+        return;
+    }
+
+    // walk along all cells crossed by the ray.
+    // Based on:
+    // John Amanatides & Andrew Woo (1987) A Fast Voxel Traversal Algorithm for Ray Tracing, Eurographics '87, 3-10
+    const double dx = receiver.x - sender.x;
+    const double dy = receiver.y - sender.y;
+    size_t col = static_cast<size_t>(sender.x / cellSize);
+    size_t row = static_cast<size_t>(sender.y / cellSize);
+    const size_t lastCol = static_cast<size_t>(receiver.x / cellSize);
+    const size_t lastRow = static_cast<size_t>(receiver.y / cellSize);
+    const bool stepColUp = lastCol > col;
+    const bool stepRowUp = lastRow > row;
+    // number of cell boundaries still to cross in each direction
+    size_t remainingCols = stepColUp ? lastCol - col : col - lastCol;
+    size_t remainingRows = stepRowUp ? lastRow - row : row - lastRow;
+    // fraction of the ray at which the next vertical (horizontal) cell boundary is crossed, and between two such boundaries
+    const double infinity = std::numeric_limits<double>::infinity();
+    double tMaxX = (remainingCols == 0) ? infinity : ((stepColUp ? (col + 1) * cellSize : col * cellSize) - sender.x) / dx;
+    double tMaxY = (remainingRows == 0) ? infinity : ((stepRowUp ? (row + 1) * cellSize : row * cellSize) - sender.y) / dy;
+    const double tDeltaX = (remainingCols == 0) ? infinity : cellSize / std::abs(dx);
+    const double tDeltaY = (remainingRows == 0) ? infinity : cellSize / std::abs(dy);
+    // tolerance for considering boundaries to be crossed at the same point
+    const double tEpsilon = 1e-9;
+
+    visitCell(col, row);
+    while (remainingCols > 0 || remainingRows > 0) {
+        const bool stepCol = (remainingCols > 0) && (remainingRows == 0 || tMaxX < tMaxY - tEpsilon);
+        const bool stepRow = (remainingRows > 0) && (remainingCols == 0 || tMaxY < tMaxX - tEpsilon);
+        if (stepCol) {
+            col = stepColUp ? col + 1 : col - 1;
+            tMaxX += tDeltaX;
+            --remainingCols;
+        }
+        else if (stepRow) {
+            row = stepRowUp ? row + 1 : row - 1;
+            tMaxY += tDeltaY;
+            --remainingRows;
+        }
+        else {
+            // ray passes (almost) exactly through a corner: also check both cells adjacent to it
+            const size_t nextCol = stepColUp ? col + 1 : col - 1;
+            const size_t nextRow = stepRowUp ? row + 1 : row - 1;
+            visitCell(nextCol, row);
+            visitCell(col, nextRow);
+            col = nextCol;
+            row = nextRow;
+            tMaxX += tDeltaX;
+            tMaxY += tDeltaY;
+            --remainingCols;
+            --remainingRows;
+        }
+        visitCell(col, row);
     }
-    return overlappingObstacles;
 }
 
 } // namespace veins
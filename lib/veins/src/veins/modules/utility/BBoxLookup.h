@@ -68,13 +68,22 @@ public:
      * Return all obstacles which have their bounding box touched by the transmission from sender to receiver.
      *
      * The obstacles itself may not actually overlap with transmission (false positives are possible).
+     * Each obstacle is returned only once.
      */
     std::vector<Obstacle*> findOverlapping(Point sender, Point receiver) const;
 
+    /**
+     * Same as findOverlapping(Point, Point), but writes the obstacles to a caller-provided buffer.
+     *
+     * The buffer is cleared first. Reusing the same buffer across calls avoids allocations.
+     */
+    void findOverlapping(Point sender, Point receiver, std::vector<Obstacle*>& overlappingObstacles) const;
+
 private:
     // NOTE: obstacles may occur multiple times in bboxes/obstacleLookup (if they are in multiple cells)
     std::vector<Box> bboxes; /**< ALL bboxes in one chunck of contiguos memory, ordered by cells */
-    std::vector<Obstacle*> obstacleLookup; /**< bboxes[i] belongs to instance in obstacleLookup[i] */
+    std::vector<size_t> obstacleLookup; /**< bboxes[i] belongs to instance obstacles[obstacleLookup[i]] */
+    std::vector<Obstacle*> obstacles; /**< all obstacles, each stored once */
     std::vector<BBoxCell> bboxCells; /**< flattened matrix of X * Y BBoxCell instances */
     int cellSize = 0;
     size_t numCols = 0; /**< X BBoxCell instances in a row */
@@ -0,0 +1,137 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#if defined(_WIN32)
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#include "veins/modules/utility/BinaryOutputVectorManager.h"
+
+using veins::BinaryOutputVectorManager;
+
+Register_Class(BinaryOutputVectorManager);
+
+Register_PerRunConfigOption(CFGID_BINARY_VECTOR_FILE, "binary-vector-file", CFG_FILENAME, "${resultdir}/${configname}-${iterationvarsf}#${repetition}.vecb", "Name of the file veins::BinaryOutputVectorManager writes output vectors to.");
+Register_PerRunConfigOption(CFGID_BINARY_VECTOR_CHUNK_SIZE, "binary-vector-chunk-size", CFG_INT, "4096", "Number of samples of an output vector veins::BinaryOutputVectorManager buffers before writing them (on a background thread).");
+Register_PerRunConfigOptionU(CFGID_BINARY_VECTOR_WINDOW, "binary-vector-window", "s", "0s", "If positive, veins::BinaryOutputVectorManager only keeps the samples of the last this many seconds of each output vector, and writes them at the end of the run.");
+
+namespace {
+
+/**
+ * create all missing parent directories of fileName (errors surface when opening the file)
+ */
+void makeParentDirectories(const std::string& fileName)
+{
+    for (size_t pos = fileName.find_first_of("/\\", 1); pos != std::string::npos; pos = fileName.find_first_of("/\\", pos + 1)) {
+        const std::string dirName = fileName.substr(0, pos);
+#if defined(_WIN32)
+        _mkdir(dirName.c_str());
+#else
+        mkdir(dirName.c_str(), 0755);
+#endif
+    }
+}
+
+} // anonymous namespace
+
+void BinaryOutputVectorManager::startRun()
+{
+    cConfiguration* config = getEnvir()->getConfig();
+    fileName = config->getAsFilename(CFGID_BINARY_VECTOR_FILE);
+    const size_t chunkSize = config->getAsInt(CFGID_BINARY_VECTOR_CHUNK_SIZE);
+    const simtime_t window = config->getAsDouble(CFGID_BINARY_VECTOR_WINDOW);
+    vectors.clear();
+    makeParentDirectories(fileName);
+    writer.reset(new BinaryVectorWriter(fileName, SimTime::getScaleExp(), chunkSize, window.raw()));
+}
+
+void BinaryOutputVectorManager::endRun()
+{
+    if (writer) writer->close();
+    writer.reset();
+}
+
+void* BinaryOutputVectorManager::registerVector(const char* modulename, const char* vectorname)
+{
+    vectors.emplace_back(new Vector());
+    Vector* vector = vectors.back().get();
+    vector->index = vectors.size() - 1;
+    vector->moduleName = modulename;
+    vector->vectorName = vectorname;
+    const std::string fullPath = vector->moduleName + "." + vector->vectorName;
+    // honor the usual per-vector opt-in and opt-out (e.g., **.vector-recording = false)
+    static cConfigOption* vectorRecording = cConfigOption::find("vector-recording");
+    vector->enabled = !vectorRecording || getEnvir()->getConfig()->getAsBool(fullPath.c_str(), vectorRecording, true);
+    return vector;
+}
+
+void BinaryOutputVectorManager::deregisterVector(void* vechandle)
+{
+    Vector* vector = static_cast<Vector*>(vechandle);
+    if (vector->declared && writer) writer->removeVector(vector->id);
+
+    // free the handle by moving the last one into its place
+    const size_t index = vector->index;
+    ASSERT(index < vectors.size() && vectors[index].get() == vector);
+    std::swap(vectors[index], vectors.back());
+    vectors[index]->index = index;
+    vectors.pop_back();
+}
+
+void BinaryOutputVectorManager::setVectorAttribute(void* vechandle, const char* name, const char* value)
+{
+    Vector* vector = static_cast<Vector*>(vechandle);
+    if (vector->declared) {
+        writer->setAttribute(vector->id, name, value);
+    }
+    else {
+        vector->attributes.emplace_back(name, value);
+    }
+}
+
+bool BinaryOutputVectorManager::record(void* vechandle, simtime_t t, double value)
+{
+    Vector* vector = static_cast<Vector*>(vechandle);
+    if (!vector->enabled || !writer) return false;
+    if (!vector->declared) {
+        vector->id = writer->addVector(vector->moduleName, vector->vectorName);
+        for (const auto& attribute : vector->attributes) {
+            writer->setAttribute(vector->id, attribute.first, attribute.second);
+        }
+        vector->attributes.clear();
+        vector->declared = true;
+    }
+    writer->record(vector->id, t.raw(), value);
+    return true;
+}
+
+const char* BinaryOutputVectorManager::getFileName() const
+{
+    return fileName.c_str();
+}
+
+void BinaryOutputVectorManager::flush()
+{
+    if (writer) writer->flush();
+}
@@ -0,0 +1,76 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "veins/veins.h"
+
+#include "veins/modules/utility/BinaryVectorWriter.h"
+
+namespace veins {
+
+/**
+ * Output vector manager that writes all output vectors (e.g., those of TraCIMobility and the MAC) to a binary, columnar file using a BinaryVectorWriter.
+ *
+ * To use, set the following in omnetpp.ini:
+ * <pre>
+ * outputvectormanager-class = "veins::BinaryOutputVectorManager"
+ * </pre>
+ * Which vectors are recorded is configured as usual (e.g., **.vector-recording = false, **.mobility.*.vector-recording = true).
+ * Further options are binary-vector-file, binary-vector-chunk-size, and binary-vector-window (only keep the samples of the last seconds of the run).
+ */
+class VEINS_API BinaryOutputVectorManager : public cIOutputVectorManager {
+public:
+    void startRun() override;
+    void endRun() override;
+    void* registerVector(const char* modulename, const char* vectorname) override;
+    void deregisterVector(void* vechandle) override;
+    void setVectorAttribute(void* vechandle, const char* name, const char* value) override;
+    bool record(void* vechandle, simtime_t t, double value) override;
+    const char* getFileName() const override;
+    void flush() override;
+
+private:
+    /**
+     * a registered vector, declared in the file when its first sample is recorded
+     */
+    struct Vector {
+        std::string moduleName;
+        std::string vectorName;
+        std::vector<std::pair<std::string, std::string>> attributes;
+        bool enabled = true;
+        bool declared = false;
+        uint32_t id = 0;
+        size_t index = 0; /**< position in vectors */
+    };
+
+    std::string fileName;
+    std::unique_ptr<BinaryVectorWriter> writer;
+    std::vector<std::unique_ptr<Vector>> vectors; /**< owns all handles given out by registerVector and not deregistered yet (kept beyond endRun, as modules are deleted after it) */
+};
+
+} // namespace veins
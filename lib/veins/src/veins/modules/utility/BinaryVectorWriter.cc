@@ -0,0 +1,234 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <algorithm>
+
+#include "veins/modules/utility/BinaryVectorWriter.h"
+
+using veins::BinaryVectorWriter;
+
+namespace {
+
+const char fileMagic[8] = {'V', 'E', 'I', 'N', 'S', 'V', 'E', 'C'};
+const uint32_t fileVersion = 1;
+
+template <typename T>
+void append(std::vector<char>& block, const T& value)
+{
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    block.insert(block.end(), bytes, bytes + sizeof(value));
+}
+
+template <typename T>
+void append(std::vector<char>& block, const std::vector<T>& column)
+{
+    const char* bytes = reinterpret_cast<const char*>(column.data());
+    block.insert(block.end(), bytes, bytes + column.size() * sizeof(T));
+}
+
+void append(std::vector<char>& block, const std::string& value)
+{
+    append(block, static_cast<uint32_t>(value.size()));
+    block.insert(block.end(), value.begin(), value.end());
+}
+
+} // anonymous namespace
+
+BinaryVectorWriter::BinaryVectorWriter(const std::string& fileName, int32_t timeScaleExponent, size_t chunkSize, int64_t window)
+    : fileName(fileName)
+    , chunkSize(std::max<size_t>(1, chunkSize))
+    , window(window)
+    , out(fileName, std::ios::binary | std::ios::trunc)
+{
+    if (!out) {
+        throw cRuntimeError("Could not open binary vector file \"%s\" for writing", fileName.c_str());
+    }
+    pending.insert(pending.end(), fileMagic, fileMagic + sizeof(fileMagic));
+    append(pending, fileVersion);
+    append(pending, timeScaleExponent);
+    writer = std::thread(&BinaryVectorWriter::writeLoop, this);
+}
+
+BinaryVectorWriter::~BinaryVectorWriter()
+{
+    try {
+        close();
+    }
+    catch (const std::exception&) {
+        // cannot report errors from a destructor: the file is incomplete
+    }
+}
+
+uint32_t BinaryVectorWriter::addVector(const std::string& moduleName, const std::string& vectorName)
+{
+    ASSERT(!closed);
+    const uint32_t vectorId = static_cast<uint32_t>(vectors.size());
+    vectors.emplace_back(new Vector());
+    numOpenVectors++;
+    if (window <= 0) {
+        vectors.back()->times.reserve(chunkSize);
+        vectors.back()->values.reserve(chunkSize);
+    }
+    append(pending, static_cast<uint8_t>(VECTOR));
+    append(pending, vectorId);
+    append(pending, moduleName);
+    append(pending, vectorName);
+    return vectorId;
+}
+
+void BinaryVectorWriter::setAttribute(uint32_t vectorId, const std::string& name, const std::string& value)
+{
+    ASSERT(!closed);
+    ASSERT(vectorId < vectors.size() && vectors[vectorId]);
+    append(pending, static_cast<uint8_t>(ATTRIBUTE));
+    append(pending, vectorId);
+    append(pending, name);
+    append(pending, value);
+}
+
+void BinaryVectorWriter::removeVector(uint32_t vectorId)
+{
+    ASSERT(!closed);
+    ASSERT(vectorId < vectors.size() && vectors[vectorId]);
+    appendRemaining(vectorId);
+    vectors[vectorId].reset();
+    numOpenVectors--;
+    // hand over the samples of removed vectors once they make up a chunk, as a full vector would
+    if (pending.size() >= chunkSize * (sizeof(int64_t) + sizeof(double))) submit();
+}
+
+void BinaryVectorWriter::record(uint32_t vectorId, int64_t time, double value)
+{
+    ASSERT(vectorId < vectors.size() && vectors[vectorId]);
+    Vector& vector = *vectors[vectorId];
+    if (window > 0) {
+        vector.window.push(Sample{time, value});
+        while (vector.window.front().time < time - window) vector.window.pop();
+        return;
+    }
+    vector.times.push_back(time);
+    vector.values.push_back(value);
+    if (vector.times.size() >= chunkSize) {
+        appendChunk(vectorId);
+        submit();
+    }
+}
+
+void BinaryVectorWriter::appendChunk(uint32_t vectorId)
+{
+    Vector& vector = *vectors[vectorId];
+    if (vector.times.empty()) return;
+    append(pending, static_cast<uint8_t>(CHUNK));
+    append(pending, vectorId);
+    append(pending, static_cast<uint32_t>(vector.times.size()));
+    append(pending, vector.times);
+    append(pending, vector.values);
+    vector.times.clear();
+    vector.values.clear();
+}
+
+void BinaryVectorWriter::appendRemaining(uint32_t vectorId)
+{
+    Vector& vector = *vectors[vectorId];
+    while (!vector.window.empty()) {
+        vector.times.push_back(vector.window.front().time);
+        vector.values.push_back(vector.window.front().value);
+        vector.window.pop();
+    }
+    appendChunk(vectorId);
+}
+
+void BinaryVectorWriter::submit()
+{
+    if (pending.empty()) return;
+    std::vector<char> block;
+    block.reserve(pending.capacity());
+    block.swap(pending);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(std::move(block));
+    }
+    changed.notify_all();
+}
+
+void BinaryVectorWriter::flush()
+{
+    ASSERT(!closed);
+    for (uint32_t vectorId = 0; vectorId < vectors.size(); ++vectorId) {
+        if (vectors[vectorId]) appendChunk(vectorId);
+    }
+    submit();
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this]() { return queue.empty() && !writing; });
+    }
+    checkWriteError();
+}
+
+void BinaryVectorWriter::close()
+{
+    if (closed) return;
+    closed = true;
+
+    for (uint32_t vectorId = 0; vectorId < vectors.size(); ++vectorId) {
+        if (vectors[vectorId]) appendRemaining(vectorId);
+    }
+    submit();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closing = true;
+    }
+    changed.notify_all();
+    writer.join();
+    out.close();
+    checkWriteError();
+}
+
+void BinaryVectorWriter::checkWriteError()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (writeFailed) {
+        throw cRuntimeError("Could not write binary vector file \"%s\"", fileName.c_str());
+    }
+}
+
+void BinaryVectorWriter::writeLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        changed.wait(lock, [this]() { return !queue.empty() || closing; });
+        if (queue.empty()) break;
+        std::vector<std::vector<char>> blocks;
+        blocks.swap(queue);
+        writing = true;
+        lock.unlock();
+        for (const auto& block : blocks) {
+            out.write(block.data(), block.size());
+        }
+        out.flush();
+        const bool failed = !out;
+        lock.lock();
+        writing = false;
+        writeFailed = writeFailed || failed;
+        changed.notify_all();
+    }
+}
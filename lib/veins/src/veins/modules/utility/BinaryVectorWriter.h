@@ -0,0 +1,145 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "veins/veins.h"
+
+#include "veins/base/utils/RingBuffer.h"
+
+namespace veins {
+
+/**
+ * Writes output vectors to a binary file, column by column, on a background thread.
+ *
+ * Samples are buffered per vector and written in chunks of chunkSize samples.
+ * Removing a vector (e.g., when its module is deleted) writes its remaining samples and frees its buffers.
+ * In window mode, only the samples of the last window time units of each vector are kept (in memory) and written when closing the file.
+ *
+ * File format (native byte order):
+ * - header: magic "VEINSVEC", uint32 version, int32 time scale exponent (times are integers in units of 10^exponent seconds)
+ * - any number of records, each starting with a uint8 record type:
+ *   - 1 (vector): uint32 vector id, string module name, string vector name
+ *   - 2 (attribute): uint32 vector id, string name, string value
+ *   - 3 (chunk): uint32 vector id, uint32 count n, n int64 times, n double values
+ * Strings are stored as uint32 length followed by the characters.
+ */
+class VEINS_API BinaryVectorWriter {
+public:
+    enum RecordType : uint8_t {
+        VECTOR = 1,
+        ATTRIBUTE = 2,
+        CHUNK = 3
+    };
+
+    /**
+     * open fileName for writing, overwriting any existing file
+     *
+     * @param window if positive, only keep the samples of the last window time units of each vector
+     */
+    BinaryVectorWriter(const std::string& fileName, int32_t timeScaleExponent, size_t chunkSize, int64_t window = 0);
+    ~BinaryVectorWriter();
+    BinaryVectorWriter(const BinaryVectorWriter&) = delete;
+    BinaryVectorWriter& operator=(const BinaryVectorWriter&) = delete;
+
+    /**
+     * declare a new vector
+     *
+     * @return the id to record samples of this vector with
+     */
+    uint32_t addVector(const std::string& moduleName, const std::string& vectorName);
+
+    void setAttribute(uint32_t vectorId, const std::string& name, const std::string& value);
+
+    /**
+     * write all remaining samples of a vector (also in window mode) and free its buffers; the id must not be used afterwards
+     */
+    void removeVector(uint32_t vectorId);
+
+    /**
+     * number of vectors added, but not removed yet
+     */
+    size_t getNumOpenVectors() const
+    {
+        return numOpenVectors;
+    }
+
+    /**
+     * record a sample (times of each vector must not decrease)
+     */
+    void record(uint32_t vectorId, int64_t time, double value);
+
+    /**
+     * write all buffered samples (except in window mode) and wait until they are in the file
+     */
+    void flush();
+
+    /**
+     * write all remaining samples and close the file (called by the destructor, if not before)
+     */
+    void close();
+
+private:
+    struct Sample {
+        int64_t time = 0;
+        double value = 0;
+    };
+    struct Vector {
+        std::vector<int64_t> times; /**< column of buffered sample times */
+        std::vector<double> values; /**< column of buffered sample values */
+        RingBuffer<Sample> window; /**< samples of the last window time units (window mode only) */
+    };
+
+    void appendChunk(uint32_t vectorId);
+    void appendRemaining(uint32_t vectorId); /**< append all buffered samples of a vector, including those in its window */
+    void submit();
+    void writeLoop();
+    void checkWriteError();
+
+    std::string fileName;
+    size_t chunkSize;
+    int64_t window;
+    std::vector<std::unique_ptr<Vector>> vectors; /**< indexed by vector id, nullptr once removed */
+    size_t numOpenVectors = 0;
+    std::vector<char> pending; /**< serialized records not yet handed to the writer thread */
+
+    std::ofstream out;
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<std::vector<char>> queue; /**< blocks to be written by the writer thread (guarded by mutex) */
+    bool writing = false; /**< whether the writer thread is writing a block (guarded by mutex) */
+    bool closing = false; /**< whether the writer thread should exit once queue is empty (guarded by mutex) */
+    bool writeFailed = false; /**< guarded by mutex */
+    bool closed = false;
+};
+
+} // namespace veins
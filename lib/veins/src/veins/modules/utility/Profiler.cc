@@ -0,0 +1,189 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "veins/modules/utility/Profiler.h"
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+using veins::Profiler::Clock;
+using veins::Profiler::Counters;
+using veins::Profiler::Scope;
+using veins::Profiler::Site;
+
+namespace veins {
+namespace Profiler {
+
+struct ThreadData {
+    std::unordered_map<uint64_t, Counters> counters; /**< by site id (upper 32 bits) and kind (lower 32 bits) */
+    std::unordered_map<uint64_t, int64_t> kinds; /**< full kind of each key in counters */
+    Scope* current = nullptr;
+};
+
+} // namespace Profiler
+} // namespace veins
+
+namespace {
+
+using veins::Profiler::ThreadData;
+
+/**
+ * state shared by all threads; records the profile at the end of each run
+ */
+class Registry : public cISimulationLifecycleListener {
+public:
+    static Registry& instance()
+    {
+        static Registry* registry = new Registry(); // never deleted, threads may still use it during shutdown
+        return *registry;
+    }
+
+    uint32_t addSite(std::string name)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        listen();
+        siteNames.push_back(std::move(name));
+        return static_cast<uint32_t>(siteNames.size() - 1);
+    }
+
+    std::shared_ptr<ThreadData> addThread()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.push_back(std::make_shared<ThreadData>());
+        return threads.back();
+    }
+
+    void lifecycleEvent(SimulationLifecycleEventType eventType, cObject* details) override
+    {
+        if (eventType == LF_POST_NETWORK_INITIALIZE) {
+            // only count the run itself
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto& thread : threads) {
+                thread->counters.clear();
+                thread->kinds.clear();
+            }
+            runStart = Clock::now();
+        }
+        else if (eventType == LF_PRE_NETWORK_FINISH) {
+            record();
+        }
+    }
+
+    std::map<std::string, Counters> profile()
+    {
+        // sum up all threads, sorted by name
+        std::map<std::string, Counters> profile;
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& thread : threads) {
+            for (auto& entry : thread->counters) {
+                std::string name = siteNames[entry.first >> 32];
+                const int64_t kind = thread->kinds[entry.first];
+                if (kind != veins::Profiler::noKind) name += "[kind=" + std::to_string(kind) + "]";
+                Counters& sum = profile[name];
+                sum.calls += entry.second.calls;
+                sum.inclusive += entry.second.inclusive;
+                sum.self += entry.second.self;
+            }
+        }
+        return profile;
+    }
+
+private:
+    void listen()
+    {
+        cEnvir* envir = cSimulation::getActiveEnvir();
+        if (envir == listening) return;
+        envir->addLifecycleListener(this);
+        listening = envir;
+        runStart = Clock::now();
+    }
+
+    void record()
+    {
+        const Clock::duration wallTime = Clock::now() - runStart;
+        const std::map<std::string, Counters> profile = this->profile();
+
+        cModule* systemModule = getSimulation()->getSystemModule();
+        auto seconds = [](Clock::duration d) { return std::chrono::duration<double>(d).count(); };
+        systemModule->recordScalar("profile:wallTime", seconds(wallTime), "s");
+        for (auto& entry : profile) {
+            systemModule->recordScalar(("profile:" + entry.first + ":calls").c_str(), entry.second.calls);
+            systemModule->recordScalar(("profile:" + entry.first + ":inclusive").c_str(), seconds(entry.second.inclusive), "s");
+            systemModule->recordScalar(("profile:" + entry.first + ":self").c_str(), seconds(entry.second.self), "s");
+        }
+    }
+
+    std::mutex mutex;
+    std::vector<std::string> siteNames; /**< by site id (guarded by mutex) */
+    std::vector<std::shared_ptr<ThreadData>> threads; /**< data of all threads that ever profiled something (guarded by mutex) */
+    cEnvir* listening = nullptr; /**< environment this is registered as a lifecycle listener with */
+    Clock::time_point runStart;
+};
+
+ThreadData& currentThread()
+{
+    // shared with the registry, so the counters of exited threads remain
+    static thread_local std::shared_ptr<ThreadData> data = Registry::instance().addThread();
+    return *data;
+}
+
+Counters& countersOf(ThreadData& thread, const Site& site, int64_t kind)
+{
+    const uint64_t key = (static_cast<uint64_t>(site.getId()) << 32) | static_cast<uint32_t>(kind);
+    auto it = thread.counters.find(key);
+    if (it != thread.counters.end()) return it->second;
+    thread.kinds[key] = kind;
+    return thread.counters[key];
+}
+
+} // anonymous namespace
+
+Site::Site(std::string name)
+    : id(Registry::instance().addSite(std::move(name)))
+{
+}
+
+Scope::Scope(const Site& site, int64_t kind)
+    : thread(currentThread())
+    , counters(countersOf(thread, site, kind))
+    , parent(thread.current)
+{
+    thread.current = this;
+    start = Clock::now();
+}
+
+Scope::~Scope()
+{
+    const Clock::duration elapsed = Clock::now() - start;
+    counters.calls++;
+    counters.inclusive += elapsed;
+    counters.self += elapsed - children;
+    if (parent) parent->children += elapsed;
+    thread.current = parent;
+}
+
+std::map<std::string, Counters> veins::Profiler::getProfile()
+{
+    return Registry::instance().profile();
+}
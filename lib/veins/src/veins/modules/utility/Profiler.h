@@ -0,0 +1,117 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "veins/veins.h"
+
+/*
+ * Scoped timing of selected code sections (define VEINS_PROFILING, e.g., via ./configure --profiling).
+ *
+ * VEINS_PROFILE_SCOPE(name) measures the wall time from the statement to the end of the enclosing scope;
+ * VEINS_PROFILE_SCOPE_KIND(name, kind) additionally breaks it down by an integer, e.g., a message kind.
+ * At the end of each run (before modules finish), the flat profile is recorded as scalars of the system module:
+ * number of calls, inclusive time, and self time (excluding nested profiled scopes) per section, plus the wall time of the run
+ * (since the end of network initialization; in the first run of a process, since the first profiled section if that comes later).
+ * Counters are kept per thread (so sections running on worker threads are covered, too) and summed up when recording.
+ *
+ * Without VEINS_PROFILING, both macros expand to nothing. The profiler itself is always compiled, but stays idle.
+ */
+#if defined(VEINS_PROFILING)
+
+#define VEINS_PROFILE_CONCAT_(a, b) a##b
+#define VEINS_PROFILE_CONCAT(a, b) VEINS_PROFILE_CONCAT_(a, b)
+#define VEINS_PROFILE_SCOPE_KIND(name, kind) \
+    static const ::veins::Profiler::Site VEINS_PROFILE_CONCAT(veinsProfileSite, __LINE__)(name); \
+    ::veins::Profiler::Scope VEINS_PROFILE_CONCAT(veinsProfileScope, __LINE__)(VEINS_PROFILE_CONCAT(veinsProfileSite, __LINE__), kind)
+#define VEINS_PROFILE_SCOPE(name) VEINS_PROFILE_SCOPE_KIND(name, ::veins::Profiler::noKind)
+
+#else
+
+#define VEINS_PROFILE_SCOPE_KIND(name, kind)
+#define VEINS_PROFILE_SCOPE(name)
+
+#endif
+
+namespace veins {
+namespace Profiler {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int64_t noKind = INT64_MIN;
+
+/**
+ * a profiled code section (one static instance per use of VEINS_PROFILE_SCOPE)
+ */
+class VEINS_API Site {
+public:
+    explicit Site(std::string name);
+
+    uint32_t getId() const
+    {
+        return id;
+    }
+
+private:
+    uint32_t id;
+};
+
+struct Counters {
+    uint64_t calls = 0;
+    Clock::duration inclusive = Clock::duration::zero();
+    Clock::duration self = Clock::duration::zero();
+};
+
+struct ThreadData;
+
+/**
+ * measures the time from construction to destruction (use VEINS_PROFILE_SCOPE instead of instantiating this directly)
+ */
+class VEINS_API Scope {
+public:
+    Scope(const Site& site, int64_t kind);
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    ThreadData& thread;
+    Counters& counters;
+    Scope* parent; /**< enclosing profiled scope on this thread (or nullptr) */
+    Clock::duration children = Clock::duration::zero(); /**< time spent in nested profiled scopes */
+    Clock::time_point start;
+};
+
+/**
+ * the flat profile of the current run, summed over all threads, by section name (suffixed with the kind, if any)
+ *
+ * Only call this while no profiled code runs on other threads.
+ */
+VEINS_API std::map<std::string, Counters> getProfile();
+
+} // namespace Profiler
+} // namespace veins
@@ -21,26 +21,72 @@
 //
 #include "veins/modules/utility/TimerManager.h"
 
-#include <algorithm>
+#include <map>
+#include <memory>
+#include <utility>
 
 using omnetpp::simTime;
 using omnetpp::simtime_t;
+using veins::CoalescedTimerGroup;
 using veins::TimerManager;
 using veins::TimerMessage;
 using veins::TimerSpecification;
 
 struct veins::TimerMessage : public omnetpp::cMessage {
-    TimerMessage(const std::string& name)
-        : omnetpp::cMessage(name.c_str())
+    /**
+     * The manager is stored as context pointer, so handleMessage can recognize its messages without RTTI.
+     */
+    TimerMessage(TimerManager* manager, size_t slot, CoalescedTimerGroup* group = nullptr)
+        : slot(slot)
+        , group(group)
     {
+        setContextPointer(manager);
     }
+
+    const size_t slot; ///< Slot of the Timer triggered by this message. Only valid when group is not set.
+    CoalescedTimerGroup* const group; ///< Group of Timers triggered by this message, if any.
 };
 
+struct veins::CoalescedTimerGroup {
+    using Key = std::pair<int64_t, int64_t>; ///< Raw interval and start time modulo interval.
+
+    struct Member {
+        TimerManager* manager; ///< nullptr if the Timer left the group while it was firing
+        size_t slot;
+    };
+
+    Key key;
+    simtime_t period; ///< Time between occurences.
+    simtime_t next; ///< Time of the next occurence.
+    std::vector<Member> members; ///< All Timers of the group.
+    TimerManager* owner; ///< Manager whose module schedules message.
+    size_t ownerMembers = 0; ///< Number of members belonging to owner.
+    TimerMessage* message = nullptr; ///< Self-message triggering all members.
+    bool firing = false; ///< Whether the callbacks of the members are currently running.
+};
+
+namespace {
+
+/**
+ * All groups of coalesced timers, shared by all TimerManagers.
+ */
+std::map<CoalescedTimerGroup::Key, std::unique_ptr<CoalescedTimerGroup>>& coalescedTimerGroups()
+{
+    static std::map<CoalescedTimerGroup::Key, std::unique_ptr<CoalescedTimerGroup>> groups;
+    return groups;
+}
+
+const int64_t slotBits = 32;
+const int64_t slotMask = (int64_t(1) << slotBits) - 1;
+
+} // namespace
+
 TimerSpecification::TimerSpecification(std::function<void()> callback)
     : start_mode_(StartMode::immediate)
     , end_mode_(EndMode::open)
     , period_(-1)
     , callback_(callback)
+    , coalesce_(false)
 {
 }
 
@@ -102,6 +148,14 @@ TimerSpecification& TimerSpecification::oneshotAt(omnetpp::simtime_t at)
     return this->absoluteStart(at).interval(1).repetitions(1);
 }
 
+TimerSpecification& TimerSpecification::coalesce(simtime_t granularity)
+{
+    ASSERT(granularity >= 0);
+    coalesce_ = true;
+    coalesce_granularity_ = granularity;
+    return *this;
+}
+
 void TimerSpecification::finalize()
 {
     switch (start_mode_) {
@@ -116,6 +170,11 @@ void TimerSpecification::finalize()
         break;
     }
 
+    if (coalesce_ && coalesce_granularity_ > 0) {
+        const int64_t granularity = coalesce_granularity_.raw();
+        start_.setRaw((start_.raw() + granularity - 1) / granularity * granularity);
+    }
+
     switch (end_mode_) {
     case EndMode::relative:
         end_time_ += simTime();
@@ -132,14 +191,6 @@ void TimerSpecification::finalize()
     }
 }
 
-bool TimerSpecification::validOccurence(simtime_t time) const
-{
-    const bool afterStart = time >= start_;
-    const bool beforeEnd = time <= end_time_;
-    const bool atPeriod = omnetpp::fmod(time - start_, period_) == 0;
-    return afterStart && (beforeEnd || end_mode_ == EndMode::open) && atPeriod;
-}
-
 TimerManager::TimerManager(omnetpp::cSimpleModule* parent)
     : parent_(parent)
 {
@@ -148,40 +199,82 @@ TimerManager::TimerManager(omnetpp::cSimpleModule* parent)
 
 TimerManager::~TimerManager()
 {
-    for (const auto& timer : timers_) {
-        parent_->cancelAndDelete(timer.first);
+    for (size_t slot = 0; slot < timers_.size(); ++slot) {
+        if (timers_[slot].active) {
+            release(slot);
+        }
+        if (timers_[slot].message) {
+            parent_->cancelAndDelete(timers_[slot].message);
+        }
     }
 }
 
 bool TimerManager::handleMessage(omnetpp::cMessage* message)
 {
-    auto* timerMessage = dynamic_cast<TimerMessage*>(message);
-    if (!timerMessage) {
+    if (message->getContextPointer() != this) {
         return false;
     }
+    auto* timerMessage = static_cast<TimerMessage*>(message);
     ASSERT(timerMessage->isSelfMessage());
-    std::string s = timerMessage->getName();
 
-    auto timer = timers_.find(timerMessage);
-    if (timer == timers_.end()) {
+    if (timerMessage->group) {
+        fireGroup(timerMessage->group);
+        return true;
+    }
+
+    const size_t slot = timerMessage->slot;
+    ASSERT(timers_[slot].message == timerMessage);
+    if (fire(slot)) {
+        parent_->scheduleAt(timers_[slot].next, timerMessage);
+    }
+
+    return true;
+}
+
+bool TimerManager::fire(size_t slot)
+{
+    // slots are kept in a deque, so this reference survives timers created by the callback
+    Timer& timer = timers_[slot];
+    ASSERT(timer.active && timer.next == simTime());
+
+    firing_ = slot;
+    firingRescheduled_ = false;
+    timer.callback();
+    firing_ = SIZE_MAX;
+
+    if (!timer.active) { // the timer was cancelled during the callback, finish releasing its slot
+        freeSlots_.push_back(slot);
         return false;
     }
-    ASSERT(timer->second.valid() && timer->second.validOccurence(simTime()));
 
-    timer->second.callback_();
+    if (!firingRescheduled_) {
+        timer.next += timer.period;
+    }
+    if (timer.openEnd || timer.next <= timer.end) {
+        return true;
+    }
+    release(slot);
+    return false;
+}
+
+void TimerManager::release(size_t slot)
+{
+    Timer& timer = timers_[slot];
+    ASSERT(timer.active);
 
-    if (timers_.find(timerMessage) != timers_.end()) { // confirm that the timer has not been cancelled during the callback
-        const auto next_event = simTime() + timer->second.period_;
-        if (timer->second.validOccurence(next_event)) {
-            parent_->scheduleAt(next_event, timer->first);
-        }
-        else {
-            parent_->cancelAndDelete(timer->first);
-            timers_.erase(timer);
-        }
+    if (timer.group) {
+        leaveGroup(slot);
+    }
+    else if (timer.message) {
+        parent_->cancelEvent(timer.message);
     }
+    timer.active = false;
+    ++timer.generation;
 
-    return true;
+    // keep the callback of a running timer alive, fire() frees the slot once it returns
+    if (slot != firing_) {
+        freeSlots_.push_back(slot);
+    }
 }
 
 TimerManager::TimerHandle TimerManager::create(TimerSpecification timerSpecification, const std::string name)
@@ -189,19 +282,213 @@ TimerManager::TimerHandle TimerManager::create(TimerSpecification timerSpecifica
     ASSERT(timerSpecification.valid());
     timerSpecification.finalize();
 
-    const auto ret = timers_.insert(std::make_pair(new TimerMessage(name), std::move(timerSpecification)));
-    ASSERT(ret.second);
-    parent_->scheduleAt(ret.first->second.start_, ret.first->first);
+    size_t slot;
+    if (freeSlots_.empty()) {
+        slot = timers_.size();
+        ASSERT(int64_t(slot) <= slotMask);
+        timers_.emplace_back();
+    }
+    else {
+        slot = freeSlots_.back();
+        freeSlots_.pop_back();
+    }
+
+    Timer& timer = timers_[slot];
+    timer.callback = std::move(timerSpecification.callback_);
+    timer.next = timerSpecification.start_;
+    timer.end = timerSpecification.end_time_;
+    timer.period = timerSpecification.period_;
+    timer.openEnd = timerSpecification.end_mode_ == TimerSpecification::EndMode::open;
+    timer.active = true;
+    const TimerHandle handle = (TimerHandle(timer.generation) << slotBits) | TimerHandle(slot);
 
-    return ret.first->first->getId();
+    if (!timer.openEnd && timer.end < timer.next) { // ends before its first occurence
+        release(slot);
+    }
+    else if (timerSpecification.coalesce_) {
+        joinGroup(slot, name);
+    }
+    else {
+        if (!timer.message) {
+            timer.message = new TimerMessage(this, slot);
+        }
+        timer.message->setName(name.c_str());
+        parent_->scheduleAt(timer.next, timer.message);
+    }
+
+    return handle;
+}
+
+size_t TimerManager::findSlot(TimerHandle handle) const
+{
+    const size_t slot = handle & slotMask;
+    const auto generation = uint32_t(handle >> slotBits);
+    if (slot < timers_.size() && timers_[slot].active && timers_[slot].generation == generation) {
+        return slot;
+    }
+    return SIZE_MAX;
 }
 
 void TimerManager::cancel(TimerManager::TimerHandle handle)
 {
-    const auto entryMatchesHandle = [handle](const std::pair<TimerMessage*, TimerSpecification>& entry) { return entry.first->getId() == handle; };
-    auto timer = std::find_if(timers_.begin(), timers_.end(), entryMatchesHandle);
-    if (timer != timers_.end()) {
-        parent_->cancelAndDelete(timer->first);
-        timers_.erase(timer);
+    const size_t slot = findSlot(handle);
+    if (slot != SIZE_MAX) {
+        release(slot);
     }
 }
+
+bool TimerManager::reschedule(TimerHandle handle, simtime_t interval, simtime_t next)
+{
+    const size_t slot = findSlot(handle);
+    if (slot == SIZE_MAX) {
+        return false;
+    }
+    ASSERT(interval > 0);
+    ASSERT(next > simTime() || (next == simTime() && slot != firing_));
+
+    Timer& timer = timers_[slot];
+    timer.period = interval;
+    timer.next = next;
+    if (slot == firing_) {
+        firingRescheduled_ = true;
+    }
+
+    if (!timer.openEnd && timer.next > timer.end) {
+        release(slot);
+    }
+    else if (timer.group) {
+        const std::string name = timer.group->message->getName();
+        leaveGroup(slot);
+        joinGroup(slot, name);
+    }
+    else if (slot != firing_) { // otherwise handleMessage() schedules the message once the callback returned
+        parent_->cancelEvent(timer.message);
+        parent_->scheduleAt(timer.next, timer.message);
+    }
+    return true;
+}
+
+void TimerManager::joinGroup(size_t slot, const std::string& name)
+{
+    Timer& timer = timers_[slot];
+    const CoalescedTimerGroup::Key key(timer.period.raw(), timer.next.raw() % timer.period.raw());
+
+    auto& entry = coalescedTimerGroups()[key];
+    if (!entry) {
+        entry.reset(new CoalescedTimerGroup());
+        entry->key = key;
+        entry->period = timer.period;
+        entry->next = timer.next;
+        entry->owner = this;
+        entry->message = new TimerMessage(this, 0, entry.get());
+        entry->message->setName(name.c_str());
+        parent_->scheduleAt(entry->next, entry->message);
+    }
+    CoalescedTimerGroup* group = entry.get();
+
+    // while firing, the only earlier occurence is the current one, which fireGroup() still visits
+    if (timer.next < group->next && !group->firing) {
+        omnetpp::cContextSwitcher switcher(group->owner->parent_);
+        group->owner->parent_->cancelEvent(group->message);
+        group->next = timer.next;
+        group->owner->parent_->scheduleAt(group->next, group->message);
+    }
+
+    timer.group = group;
+    timer.groupIndex = group->members.size();
+    group->members.push_back({this, slot});
+    if (group->owner == this) {
+        ++group->ownerMembers;
+    }
+}
+
+void TimerManager::leaveGroup(size_t slot)
+{
+    Timer& timer = timers_[slot];
+    CoalescedTimerGroup* group = timer.group;
+    timer.group = nullptr;
+    if (group->owner == this) {
+        --group->ownerMembers;
+    }
+
+    auto& members = group->members;
+    if (group->firing) { // fireGroup() removes the entry once all callbacks ran
+        members[timer.groupIndex].manager = nullptr;
+        return;
+    }
+
+    members[timer.groupIndex] = members.back();
+    members[timer.groupIndex].manager->timers_[members[timer.groupIndex].slot].groupIndex = timer.groupIndex;
+    members.pop_back();
+    updateGroupOwner(group);
+}
+
+void TimerManager::fireGroup(CoalescedTimerGroup* group)
+{
+    const simtime_t now = simTime();
+    ASSERT(group->next == now);
+    group->next = now + group->period;
+
+    group->firing = true;
+    for (size_t i = 0; i < group->members.size(); ++i) {
+        const auto member = group->members[i];
+        if (member.manager && member.manager->timers_[member.slot].next == now) {
+            omnetpp::cContextSwitcher switcher(member.manager->parent_);
+            member.manager->fire(member.slot);
+        }
+    }
+    group->firing = false;
+
+    // remove the timers which left during their callbacks
+    auto& members = group->members;
+    size_t kept = 0;
+    for (size_t i = 0; i < members.size(); ++i) {
+        if (!members[i].manager) continue;
+        members[kept] = members[i];
+        members[kept].manager->timers_[members[kept].slot].groupIndex = kept;
+        ++kept;
+    }
+    members.resize(kept);
+
+    if (updateGroupOwner(group) && !group->message->isScheduled()) {
+        omnetpp::cContextSwitcher switcher(group->owner->parent_);
+        group->owner->parent_->scheduleAt(group->next, group->message);
+    }
+}
+
+bool TimerManager::updateGroupOwner(CoalescedTimerGroup* group)
+{
+    if (group->members.empty()) {
+        {
+            omnetpp::cContextSwitcher switcher(group->owner->parent_);
+            group->owner->parent_->cancelAndDelete(group->message);
+        }
+        coalescedTimerGroups().erase(group->key);
+        return false;
+    }
+    if (group->ownerMembers > 0) {
+        return true;
+    }
+
+    // the owning module left the group, move the message to the module of another member
+    const bool scheduled = group->message->isScheduled();
+    const std::string name = group->message->getName();
+    {
+        omnetpp::cContextSwitcher switcher(group->owner->parent_);
+        group->owner->parent_->cancelAndDelete(group->message);
+    }
+    group->owner = group->members.front().manager;
+    group->ownerMembers = 0;
+    for (const auto& member : group->members) {
+        if (member.manager == group->owner) {
+            ++group->ownerMembers;
+        }
+    }
+    omnetpp::cContextSwitcher switcher(group->owner->parent_);
+    group->message = new TimerMessage(group->owner, 0, group);
+    group->message->setName(name.c_str());
+    if (scheduled) {
+        group->owner->parent_->scheduleAt(group->next, group->message);
+    }
+    return true;
+}
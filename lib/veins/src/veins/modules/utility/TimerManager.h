@@ -21,9 +21,11 @@
 //
 #pragma once
 
+#include <cstdint>
+#include <deque>
 #include <functional>
-#include <map>
 #include <string>
+#include <vector>
 
 #include "veins/veins.h"
 
@@ -48,6 +50,13 @@ class TimerManager;
  */
 struct TimerMessage;
 
+/**
+ * Timers of (possibly) different modules which share their events.
+ *
+ * @see TimerSpecification::coalesce
+ */
+struct CoalescedTimerGroup;
+
 /**
  * A class which specifies a Timer.
  *
@@ -142,6 +151,16 @@ public:
      */
     TimerSpecification& oneshotAt(omnetpp::simtime_t at);
 
+    /**
+     * Let this timer share events with the timers of other modules that fire at the same times.
+     *
+     * Periodic timers with the same interval whose start times differ by a multiple of it are triggered by a single self-message, reducing the number of events in the FES.
+     * Each callback runs in the context of the module that created the timer; the order of callbacks sharing an event is deterministic but unspecified.
+     *
+     * @param granularity If positive, the start time is delayed to the next multiple of this value, so timers with (e.g., random) start offsets can share events.
+     */
+    TimerSpecification& coalesce(omnetpp::simtime_t granularity = SIMTIME_ZERO);
+
 private:
     friend TimerManager;
 
@@ -172,11 +191,6 @@ private:
         return period_ != -1;
     }
 
-    /**
-     * Check that the given time is a valid occurence for this timer.
-     */
-    bool validOccurence(omnetpp::simtime_t time) const;
-
     StartMode start_mode_; ///< Interpretation of start time._
     omnetpp::simtime_t start_; ///< Time of the Timer's first occurence. Interpretation depends on start_mode_.
     EndMode end_mode_; ///< Interpretation of end time._
@@ -184,13 +198,18 @@ private:
     omnetpp::simtime_t end_time_; ///< Last possible occurence of the timer. Only valid when end_mode_ != repetition.
     omnetpp::simtime_t period_; ///< Time between events.
     std::function<void()> callback_; ///< The function to be called when the Timer is triggered.
+    bool coalesce_; ///< Whether this Timer may share events with Timers of other modules.
+    omnetpp::simtime_t coalesce_granularity_; ///< Grid the start time is aligned to. Only valid when coalesce_ is set.
 };
 
 class VEINS_API TimerManager {
-private:
 public:
-    using TimerHandle = long;
-    using TimerList = std::map<TimerMessage*, const TimerSpecification>;
+    /**
+     * Identifies a timer of a TimerManager.
+     *
+     * Handles of cancelled or expired timers are never reused, and no valid handle is 0.
+     */
+    using TimerHandle = int64_t;
 
     TimerManager(omnetpp::cSimpleModule* parent);
 
@@ -230,8 +249,80 @@ public:
      */
     void cancel(TimerHandle handle);
 
+    /**
+     * Change the interval and next occurence of a timer, reusing its message and callback.
+     *
+     * Can also be called from the timer's own callback. The end time of the timer is kept; if the new next occurence lies after it, the timer expires.
+     *
+     * @param handle A handle which identifies the timer.
+     * @param interval The new period between two occurences.
+     * @param next Absolute time of the next occurence. Must not be earlier than the current simtime (nor equal to it when called from the timer's own callback).
+     * @return false, if the timer has already expired or was cancelled.
+     */
+    bool reschedule(TimerHandle handle, omnetpp::simtime_t interval, omnetpp::simtime_t next);
+
 private:
-    TimerList timers_; ///< List of all active Timers.
+    /**
+     * Slot of the slot map holding the timers.
+     *
+     * Slots are reused (including their message) after their timer expired or was cancelled.
+     */
+    struct Timer {
+        std::function<void()> callback; ///< The function to be called when the Timer is triggered.
+        omnetpp::simtime_t next; ///< Time of the next occurence.
+        omnetpp::simtime_t end; ///< Last possible occurence. Only valid when openEnd is not set.
+        omnetpp::simtime_t period; ///< Time between occurences.
+        bool openEnd = false; ///< Whether the Timer runs until the end of the simulation.
+        bool active = false; ///< Whether this slot currently holds a Timer.
+        uint32_t generation = 1; ///< Incremented whenever the slot is freed, invalidating old handles.
+        TimerMessage* message = nullptr; ///< Self-message of this slot. Unused while the Timer is coalesced.
+        CoalescedTimerGroup* group = nullptr; ///< The group the Timer shares its events with, if any.
+        size_t groupIndex = 0; ///< Position of the Timer among the members of group.
+    };
+
+    /**
+     * Run the callback of the timer in the given slot and schedule its next occurence.
+     *
+     * @return whether the Timer will occur again.
+     */
+    bool fire(size_t slot);
+
+    /**
+     * Get the slot of the timer identified by handle, or SIZE_MAX if the timer expired or was cancelled.
+     */
+    size_t findSlot(TimerHandle handle) const;
+
+    /**
+     * Free the given slot, making its handle invalid.
+     */
+    void release(size_t slot);
+
+    /**
+     * Add the timer in the given slot to the group of all timers sharing its occurences, creating the group if needed.
+     */
+    void joinGroup(size_t slot, const std::string& name);
+
+    /**
+     * Remove the timer in the given slot from its group.
+     */
+    void leaveGroup(size_t slot);
+
+    /**
+     * Trigger all timers of a group.
+     */
+    static void fireGroup(CoalescedTimerGroup* group);
+
+    /**
+     * Delete the group if it became empty, or hand its message over to another module if the owning one left.
+     *
+     * @return whether the group still exists.
+     */
+    static bool updateGroupOwner(CoalescedTimerGroup* group);
+
+    std::deque<Timer> timers_; ///< Slot map of all Timers. A deque keeps callbacks in place while slots are added.
+    std::vector<size_t> freeSlots_; ///< Slots which do not hold a Timer.
+    size_t firing_ = SIZE_MAX; ///< Slot whose callback is currently running, if any.
+    bool firingRescheduled_ = false; ///< Whether the running callback rescheduled its own timer.
     omnetpp::cSimpleModule* const parent_; ///< A pointer to the module which owns this TimerManager.
 };
 
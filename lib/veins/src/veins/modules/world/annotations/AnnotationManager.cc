@@ -301,6 +301,7 @@ void AnnotationManager::scheduleErase(simtime_t deltaT, Annotation* annotation)
 
 void AnnotationManager::show(const Annotation* annotation)
 {
+    if (headless) return;
     if (annotation->figure) return;
 
     if (const Point* o = dynamic_cast<const Point*>(annotation)) {
@@ -98,9 +98,66 @@ cModule* findModuleByPath(T modulePath)
 #endif
 }
 
+/**
+ * Whether Veins was built without support for graphical user interfaces (define VEINS_HEADLESS, e.g., via ./configure --headless).
+ *
+ * If so, display string updates and annotations (in OMNeT++ as well as in the TraCI server) are compiled out.
+ */
+#if defined(VEINS_HEADLESS)
+constexpr bool headless = true;
+#else
+constexpr bool headless = false;
+#endif
+
 #if OMNETPP_VERSION < 0x600
 typedef long intval_t;
 typedef unsigned long uintval_t;
 #endif
 
 } // namespace veins
+
+/*
+ * Log statements below a minimum level can be compiled out (define VEINS_MIN_LOG_LEVEL, e.g., via make MODE=release VEINS_MIN_LOG_LEVEL=WARN).
+ *
+ * Unlike the runtime log level of OMNeT++, this also skips evaluating the arguments of these statements.
+ */
+#define VEINS_LOG_LEVEL_TRACE 0
+#define VEINS_LOG_LEVEL_DEBUG 1
+#define VEINS_LOG_LEVEL_DETAIL VEINS_LOG_LEVEL_DEBUG
+#define VEINS_LOG_LEVEL_INFO 2
+#define VEINS_LOG_LEVEL_WARN 3
+#define VEINS_LOG_LEVEL_ERROR 4
+
+#if defined(VEINS_MIN_LOG_LEVEL)
+// still type-checks the statement in the same context, but never executes it
+#define VEINS_LOG_DISABLED(logLevel) while (false) EV_LOG(logLevel, nullptr)
+
+#if VEINS_MIN_LOG_LEVEL > VEINS_LOG_LEVEL_TRACE
+#undef EV_TRACE
+#define EV_TRACE VEINS_LOG_DISABLED(omnetpp::LOGLEVEL_TRACE)
+#endif
+
+#if VEINS_MIN_LOG_LEVEL > VEINS_LOG_LEVEL_DEBUG
+#undef EV_DEBUG
+#undef EV_DETAIL
+#define EV_DEBUG VEINS_LOG_DISABLED(omnetpp::LOGLEVEL_DEBUG)
+#define EV_DETAIL VEINS_LOG_DISABLED(omnetpp::LOGLEVEL_DETAIL)
+#endif
+
+#if VEINS_MIN_LOG_LEVEL > VEINS_LOG_LEVEL_INFO
+#undef EV
+#undef EV_INFO
+#define EV VEINS_LOG_DISABLED(omnetpp::LOGLEVEL_INFO)
+#define EV_INFO VEINS_LOG_DISABLED(omnetpp::LOGLEVEL_INFO)
+#endif
+
+#if VEINS_MIN_LOG_LEVEL > VEINS_LOG_LEVEL_WARN
+#undef EV_WARN
+#define EV_WARN VEINS_LOG_DISABLED(omnetpp::LOGLEVEL_WARN)
+#endif
+
+#if VEINS_MIN_LOG_LEVEL > VEINS_LOG_LEVEL_ERROR
+#undef EV_ERROR
+#define EV_ERROR VEINS_LOG_DISABLED(omnetpp::LOGLEVEL_ERROR)
+#endif
+#endif
@@ -0,0 +1,220 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <fstream>
+#include <memory>
+#include <random>
+#include <regex>
+#include <sstream>
+
+#include "catch2/catch.hpp"
+
+#include "veins/modules/obstacle/Obstacle.h"
+#include "veins/modules/utility/BBoxLookup.h"
+
+using veins::BBoxLookup;
+using veins::Coord;
+using veins::Obstacle;
+
+namespace {
+
+BBoxLookup::Box makeBBox(Obstacle* o)
+{
+    return {{o->getBboxP1().x, o->getBboxP1().y}, {o->getBboxP2().x, o->getBboxP2().y}};
+}
+
+/**
+ * return all obstacles whose bounding box is touched by the line from sender to receiver (by testing all of them)
+ */
+std::vector<Obstacle*> bruteForceOverlapping(const std::vector<Obstacle*>& obstacles, BBoxLookup::Point sender, BBoxLookup::Point receiver)
+{
+    std::vector<Obstacle*> result;
+    for (auto o : obstacles) {
+        auto box = makeBBox(o);
+        // Liang-Barsky clipping of the line against the box
+        double t0 = 0;
+        double t1 = 1;
+        const double p[4] = {-(receiver.x - sender.x), receiver.x - sender.x, -(receiver.y - sender.y), receiver.y - sender.y};
+        const double q[4] = {sender.x - box.p1.x, box.p2.x - sender.x, sender.y - box.p1.y, box.p2.y - sender.y};
+        bool hit = true;
+        for (int i = 0; i < 4 && hit; ++i) {
+            if (p[i] == 0) {
+                hit = q[i] >= 0;
+                continue;
+            }
+            const double t = q[i] / p[i];
+            if (p[i] < 0) t0 = std::max(t0, t);
+            if (p[i] > 0) t1 = std::min(t1, t);
+            hit = t0 <= t1;
+        }
+        if (hit) result.push_back(o);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+/**
+ * read all polygons of a SUMO poly file, moved such that their bounding box starts at (0, 0)
+ */
+std::vector<std::unique_ptr<Obstacle>> readPolyFile(const std::string& fileName, double& sizeX, double& sizeY)
+{
+    std::vector<std::unique_ptr<Obstacle>> obstacles;
+    std::vector<std::vector<Coord>> shapes;
+    std::ifstream in(fileName);
+    std::stringstream content;
+    content << in.rdbuf();
+    const std::string text = content.str();
+
+    const std::regex shapeRegex("<poly [^>]*shape=\"([^\"]*)\"");
+    Coord minPos(1e300, 1e300);
+    Coord maxPos(-1e300, -1e300);
+    for (auto it = std::sregex_iterator(text.begin(), text.end(), shapeRegex); it != std::sregex_iterator(); ++it) {
+        std::vector<Coord> shape;
+        std::istringstream points((*it)[1].str());
+        std::string point;
+        while (points >> point) {
+            const size_t comma = point.find(',');
+            Coord c(std::stod(point.substr(0, comma)), std::stod(point.substr(comma + 1)));
+            minPos = Coord(std::min(minPos.x, c.x), std::min(minPos.y, c.y));
+            maxPos = Coord(std::max(maxPos.x, c.x), std::max(maxPos.y, c.y));
+            shape.push_back(c);
+        }
+        shapes.push_back(shape);
+    }
+    for (auto& shape : shapes) {
+        for (auto& c : shape) c -= minPos;
+        obstacles.emplace_back(new Obstacle(std::to_string(obstacles.size()), "building", 9, 0.4));
+        obstacles.back()->setShape(shape);
+    }
+    sizeX = maxPos.x - minPos.x;
+    sizeY = maxPos.y - minPos.y;
+    return obstacles;
+}
+
+/**
+ * find a file given relative to the Veins root directory
+ */
+std::string findFile(const std::string& relativePath)
+{
+    for (std::string prefix : {"../../", "../../../"}) {
+        if (std::ifstream(prefix + relativePath)) return prefix + relativePath;
+    }
+    return "";
+}
+
+} // anonymous namespace
+
+SCENARIO("BBoxLookup", "[bboxLookup]")
+{
+    GIVEN("A grid of 20 x 20 obstacles on a 1000m x 1000m playground with 100m cells")
+    {
+        std::vector<std::unique_ptr<Obstacle>> owner;
+        std::vector<Obstacle*> obstacles;
+        for (int x = 0; x < 20; ++x) {
+            for (int y = 0; y < 20; ++y) {
+                owner.emplace_back(new Obstacle(std::to_string(owner.size()), "building", 9, 0.4));
+                owner.back()->setShape({Coord(x * 50 + 10, y * 50 + 10), Coord(x * 50 + 40, y * 50 + 10), Coord(x * 50 + 40, y * 50 + 40), Coord(x * 50 + 10, y * 50 + 40)});
+                obstacles.push_back(owner.back().get());
+            }
+        }
+        // one large obstacle spanning many cells
+        owner.emplace_back(new Obstacle(std::to_string(owner.size()), "building", 9, 0.4));
+        owner.back()->setShape({Coord(120, 620), Coord(880, 620), Coord(880, 630), Coord(120, 630)});
+        obstacles.push_back(owner.back().get());
+
+        BBoxLookup lookup(obstacles, makeBBox, 1000, 1000, 100);
+
+        THEN("a diagonal link through cell corners finds the same obstacles as a brute-force search")
+        {
+            auto found = lookup.findOverlapping({5, 5}, {995, 995});
+            std::sort(found.begin(), found.end());
+            REQUIRE(found == bruteForceOverlapping(obstacles, {5, 5}, {995, 995}));
+        }
+
+        THEN("each obstacle is reported only once")
+        {
+            auto found = lookup.findOverlapping({100, 625}, {900, 625});
+            REQUIRE(std::count(found.begin(), found.end(), owner.back().get()) == 1);
+        }
+
+        THEN("random links find the same obstacles as a brute-force search")
+        {
+            std::mt19937 rng(42);
+            std::uniform_real_distribution<double> pos(0, 1000);
+            std::vector<Obstacle*> found;
+            for (int i = 0; i < 1000; ++i) {
+                BBoxLookup::Point sender{pos(rng), pos(rng)};
+                BBoxLookup::Point receiver{pos(rng), pos(rng)};
+                lookup.findOverlapping(sender, receiver, found);
+                std::sort(found.begin(), found.end());
+                REQUIRE(found == bruteForceOverlapping(obstacles, sender, receiver));
+            }
+        }
+    }
+}
+
+SCENARIO("BBoxLookup performance", "[.][benchmark][bboxLookup]")
+{
+    for (std::string polyFile : {"../../scenario/manhattan.poly.xml", "examples/veins/erlangen.poly.xml"}) {
+        const std::string fileName = findFile(polyFile);
+        if (fileName.empty()) {
+            WARN("Could not find " << polyFile << ", skipping");
+            continue;
+        }
+
+        GIVEN("The obstacles of " + polyFile)
+        {
+            double sizeX;
+            double sizeY;
+            auto owner = readPolyFile(fileName, sizeX, sizeY);
+            REQUIRE(!owner.empty());
+            std::vector<Obstacle*> obstacles;
+            for (auto& o : owner) obstacles.push_back(o.get());
+
+            // fixed set of links of up to 1000m length
+            std::mt19937 rng(42);
+            std::uniform_real_distribution<double> posX(0, sizeX);
+            std::uniform_real_distribution<double> posY(0, sizeY);
+            std::uniform_real_distribution<double> offset(-1000, 1000);
+            std::vector<std::pair<BBoxLookup::Point, BBoxLookup::Point>> links;
+            for (int i = 0; i < 100000; ++i) {
+                BBoxLookup::Point sender{posX(rng), posY(rng)};
+                BBoxLookup::Point receiver{std::min(std::max(sender.x + offset(rng), 0.0), sizeX), std::min(std::max(sender.y + offset(rng), 0.0), sizeY)};
+                links.emplace_back(sender, receiver);
+            }
+
+            for (int cellSize : {50, 250}) {
+                BBoxLookup lookup(obstacles, makeBBox, sizeX, sizeY, cellSize);
+                std::vector<Obstacle*> found;
+                size_t numFound = 0;
+                BENCHMARK(polyFile + ", " + std::to_string(cellSize) + "m cells, 100000 links")
+                {
+                    for (auto& link : links) {
+                        lookup.findOverlapping(link.first, link.second, found);
+                        numFound += found.size();
+                    }
+                }
+                REQUIRE(numFound > 0);
+            }
+        }
+    }
+}
@@ -0,0 +1,238 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+
+#include "catch2/catch.hpp"
+
+#include "veins/modules/utility/BinaryVectorWriter.h"
+
+using veins::BinaryVectorWriter;
+
+namespace {
+
+/**
+ * contents of a binary vector file, reassembled per vector
+ */
+struct VectorFile {
+    int32_t timeScaleExponent = 0;
+    std::map<uint32_t, std::string> names; /**< "module.vector" */
+    std::map<uint32_t, std::map<std::string, std::string>> attributes;
+    std::map<uint32_t, std::vector<std::pair<int64_t, double>>> samples;
+};
+
+template <typename T>
+T readValue(const std::vector<char>& data, size_t& pos)
+{
+    REQUIRE(pos + sizeof(T) <= data.size());
+    T value;
+    std::memcpy(&value, data.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return value;
+}
+
+std::string readString(const std::vector<char>& data, size_t& pos)
+{
+    const uint32_t size = readValue<uint32_t>(data, pos);
+    REQUIRE(pos + size <= data.size());
+    std::string value(data.data() + pos, size);
+    pos += size;
+    return value;
+}
+
+VectorFile readVectorFile(const std::string& fileName)
+{
+    std::ifstream in(fileName, std::ios::binary);
+    const std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    REQUIRE(data.size() >= 16);
+    REQUIRE(std::string(data.data(), 8) == "VEINSVEC");
+    size_t pos = 8;
+    REQUIRE(readValue<uint32_t>(data, pos) == 1);
+    VectorFile file;
+    file.timeScaleExponent = readValue<int32_t>(data, pos);
+    while (pos < data.size()) {
+        const uint8_t type = readValue<uint8_t>(data, pos);
+        const uint32_t vectorId = readValue<uint32_t>(data, pos);
+        if (type == BinaryVectorWriter::VECTOR) {
+            const std::string moduleName = readString(data, pos);
+            file.names[vectorId] = moduleName + "." + readString(data, pos);
+        }
+        else if (type == BinaryVectorWriter::ATTRIBUTE) {
+            const std::string name = readString(data, pos);
+            file.attributes[vectorId][name] = readString(data, pos);
+        }
+        else {
+            REQUIRE(type == BinaryVectorWriter::CHUNK);
+            REQUIRE(file.names.count(vectorId) == 1);
+            const uint32_t count = readValue<uint32_t>(data, pos);
+            std::vector<int64_t> times;
+            for (uint32_t i = 0; i < count; ++i) times.push_back(readValue<int64_t>(data, pos));
+            for (uint32_t i = 0; i < count; ++i) file.samples[vectorId].emplace_back(times[i], readValue<double>(data, pos));
+        }
+    }
+    return file;
+}
+
+} // anonymous namespace
+
+SCENARIO("BinaryVectorWriter", "[binaryVectorWriter]")
+{
+    const std::string fileName = "binaryVectorWriter.test.vecb";
+
+    GIVEN("A writer with chunks of 2 samples")
+    {
+        BinaryVectorWriter writer(fileName, -12, 2);
+        const uint32_t speed = writer.addVector("scenario.node[0].veinsmobility", "speed");
+        writer.setAttribute(speed, "unit", "mps");
+        const uint32_t posX = writer.addVector("scenario.node[0].veinsmobility", "posx");
+
+        WHEN("recording samples of both vectors")
+        {
+            for (int64_t t = 0; t < 5; ++t) writer.record(speed, t, t * 1.5);
+            writer.flush();
+            writer.record(posX, 3, 42);
+            writer.close();
+
+            THEN("all samples are written, in order")
+            {
+                VectorFile file = readVectorFile(fileName);
+                REQUIRE(file.timeScaleExponent == -12);
+                REQUIRE(file.names[speed] == "scenario.node[0].veinsmobility.speed");
+                REQUIRE(file.attributes[speed]["unit"] == "mps");
+                REQUIRE(file.samples[speed].size() == 5);
+                for (int64_t t = 0; t < 5; ++t) {
+                    REQUIRE(file.samples[speed][t] == std::make_pair(t, t * 1.5));
+                }
+                REQUIRE(file.samples[posX].size() == 1);
+                REQUIRE(file.samples[posX][0] == std::make_pair(int64_t(3), 42.0));
+            }
+        }
+    }
+
+    GIVEN("A writer in window mode, keeping the last 10 time units")
+    {
+        BinaryVectorWriter writer(fileName, -12, 2, 10);
+        const uint32_t speed = writer.addVector("node", "speed");
+
+        WHEN("recording 100 time units of samples")
+        {
+            for (int64_t t = 0; t <= 100; ++t) writer.record(speed, t, t);
+            writer.close();
+
+            THEN("only the samples of the last 10 time units are written")
+            {
+                VectorFile file = readVectorFile(fileName);
+                REQUIRE(file.samples[speed].size() == 11);
+                REQUIRE(file.samples[speed].front().first == 90);
+                REQUIRE(file.samples[speed].back().first == 100);
+            }
+        }
+    }
+
+    GIVEN("Many short-lived vectors (like those of vehicles arriving and leaving)")
+    {
+        const uint32_t numVectors = 1000;
+
+        WHEN("removing each vector after recording a few samples")
+        {
+            BinaryVectorWriter writer(fileName, -12, 4096);
+            for (uint32_t v = 0; v < numVectors; ++v) {
+                const uint32_t id = writer.addVector("scenario.node[" + std::to_string(v) + "].veinsmobility", "posx");
+                for (int64_t t = 0; t < 3; ++t) writer.record(id, v + t, v * 10.0 + t);
+                writer.removeVector(id);
+            }
+
+            THEN("no vector stays open")
+            {
+                REQUIRE(writer.getNumOpenVectors() == 0);
+            }
+
+            THEN("all samples are written")
+            {
+                writer.close();
+                VectorFile file = readVectorFile(fileName);
+                REQUIRE(file.names.size() == numVectors);
+                for (uint32_t v = 0; v < numVectors; ++v) {
+                    REQUIRE(file.samples[v].size() == 3);
+                    REQUIRE(file.samples[v][2] == std::make_pair(int64_t(v + 2), v * 10.0 + 2));
+                }
+            }
+        }
+
+        WHEN("removing each vector in window mode")
+        {
+            BinaryVectorWriter writer(fileName, -12, 4096, 10);
+            for (uint32_t v = 0; v < numVectors; ++v) {
+                const uint32_t id = writer.addVector("node", "speed");
+                for (int64_t t = 0; t <= 20; ++t) writer.record(id, t, v);
+                writer.removeVector(id);
+            }
+            writer.close();
+
+            THEN("the last window of each vector is written")
+            {
+                VectorFile file = readVectorFile(fileName);
+                for (uint32_t v = 0; v < numVectors; ++v) {
+                    REQUIRE(file.samples[v].size() == 11);
+                    REQUIRE(file.samples[v].front().first == 10);
+                }
+            }
+        }
+    }
+
+    std::remove(fileName.c_str());
+}
+
+SCENARIO("BinaryVectorWriter performance", "[.][benchmark][binaryVectorWriter]")
+{
+    GIVEN("100 vectors with 10000 samples each, recorded round-robin (like mobility vectors of 100 vehicles)")
+    {
+        const std::string fileName = "binaryVectorWriter.benchmark";
+        const int numVectors = 100;
+        const int numSamples = 10000;
+
+        BENCHMARK("text vector file (as written by OMNeT++)")
+        {
+            std::ofstream out(fileName);
+            for (int v = 0; v < numVectors; ++v) out << "vector " << v << " scenario.node[" << v << "].veinsmobility posx ETV\n";
+            for (int i = 0; i < numSamples; ++i) {
+                for (int v = 0; v < numVectors; ++v) out << v << "\t" << i << "\t" << i * 0.1 << "\t" << i * 1.234 + v << "\n";
+            }
+        }
+
+        BENCHMARK("binary vector file")
+        {
+            BinaryVectorWriter writer(fileName, -12, 4096);
+            for (int v = 0; v < numVectors; ++v) writer.addVector("scenario.node[" + std::to_string(v) + "].veinsmobility", "posx");
+            for (int i = 0; i < numSamples; ++i) {
+                for (int v = 0; v < numVectors; ++v) writer.record(static_cast<uint32_t>(v), i * int64_t(100000000000), i * 1.234 + v);
+            }
+            writer.close();
+        }
+
+        std::remove(fileName.c_str());
+    }
+}
@@ -0,0 +1,79 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "catch2/catch.hpp"
+
+#include "veins/base/utils/CounterBasedRNG.h"
+
+using veins::CounterBasedRNG;
+
+SCENARIO("CounterBasedRNG", "[counterBasedRng]")
+{
+    GIVEN("The Philox4x32-10 bijection")
+    {
+        THEN("it reproduces the known answers of the reference implementation")
+        {
+            REQUIRE(CounterBasedRNG::philox({0, 0, 0, 0}, {0, 0}) == CounterBasedRNG::Block{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8});
+            REQUIRE(CounterBasedRNG::philox({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff}) == CounterBasedRNG::Block{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd});
+            REQUIRE(CounterBasedRNG::philox({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}) == CounterBasedRNG::Block{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1});
+        }
+    }
+
+    GIVEN("Two generators for the same seed and stream and one for a different stream")
+    {
+        CounterBasedRNG a(42, {1, 2, 3, 4});
+        CounterBasedRNG b(42, {1, 2, 3, 4});
+        CounterBasedRNG c(42, {1, 2, 3, 5});
+
+        THEN("the same stream yields bit-identical numbers, different streams do not")
+        {
+            int numDifferent = 0;
+            for (int i = 0; i < 100; ++i) {
+                const double x = a.gamma(0.75, 2);
+                REQUIRE(x == b.gamma(0.75, 2));
+                if (x != c.gamma(0.75, 2)) ++numDifferent;
+            }
+            REQUIRE(numDifferent == 100);
+        }
+    }
+
+    GIVEN("Many draws from a gamma distribution with shape 0.75 and scale 2")
+    {
+        CounterBasedRNG rng(1, {0, 0, 0, 0});
+        const int n = 100000;
+        double sum = 0;
+        double sumSquares = 0;
+        for (int i = 0; i < n; ++i) {
+            const double x = rng.gamma(0.75, 2);
+            REQUIRE(x > 0);
+            sum += x;
+            sumSquares += x * x;
+        }
+
+        THEN("mean and variance match the distribution")
+        {
+            const double mean = sum / n;
+            REQUIRE(mean == Approx(1.5).epsilon(0.02));
+            REQUIRE(sumSquares / n - mean * mean == Approx(3).epsilon(0.05));
+        }
+    }
+}
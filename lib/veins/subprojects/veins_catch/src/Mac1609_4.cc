@@ -0,0 +1,241 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <memory>
+
+#include "catch2/catch.hpp"
+
+#include "veins/base/utils/RingBuffer.h"
+#include "veins/modules/mac/ieee80211p/Mac1609_4.h"
+#include "veins/modules/utility/SignalManager.h"
+#include "testutils/Simulation.h"
+
+using veins::BaseFrame1609_4;
+using veins::ChannelType;
+using veins::Mac1609_4;
+using veins::RingBuffer;
+using veins::SignalManager;
+using veins::SignalPayload;
+
+namespace {
+
+class DummyModule : public cSimpleModule {
+};
+
+class ObservableMac : public Mac1609_4 {
+public:
+    using Mac1609_4::notifyChannelBusy;
+};
+
+class CountingObserver : public Mac1609_4::ChannelBusyObserver {
+public:
+    void channelBusyChanged(simtime_t time, bool busy) override
+    {
+        numBusy += busy ? 1 : 0;
+        numIdle += busy ? 0 : 1;
+    }
+
+    long numBusy = 0;
+    long numIdle = 0;
+};
+
+} // anonymous namespace
+
+SCENARIO("RingBuffer", "[mac]")
+{
+    GIVEN("A ring buffer with capacity 3")
+    {
+        RingBuffer<int> buffer(3);
+        REQUIRE(buffer.empty());
+        REQUIRE(buffer.capacity() == 3);
+
+        WHEN("elements are pushed and popped repeatedly")
+        {
+            int next = 0;
+            int expected = 0;
+            for (int round = 0; round < 10; ++round) {
+                buffer.push(next++);
+                buffer.push(next++);
+                REQUIRE(buffer.front() == expected++);
+                buffer.pop();
+                REQUIRE(buffer.front() == expected++);
+                buffer.pop();
+            }
+
+            THEN("they come out in order without growing the buffer")
+            {
+                REQUIRE(buffer.empty());
+                REQUIRE(buffer.capacity() == 3);
+            }
+        }
+
+        WHEN("more elements than its capacity are pushed")
+        {
+            buffer.push(0);
+            buffer.pop();
+            for (int i = 1; i <= 5; ++i) buffer.push(i);
+
+            THEN("the buffer grows and keeps the order")
+            {
+                REQUIRE(buffer.size() == 5);
+                REQUIRE(buffer.capacity() >= 5);
+                for (int i = 1; i <= 5; ++i) {
+                    REQUIRE(buffer.front() == i);
+                    buffer.pop();
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Mac1609_4 EDCA performance", "[.][benchmark][mac]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr));
+    DummyModule owner;
+
+    GIVEN("An EDCA subsystem with four filled queues")
+    {
+        const int queueSize = 8;
+        Mac1609_4::EDCA edca(&owner, ChannelType::control, queueSize);
+        edca.createQueue(2, 3, 7, Mac1609_4::AC_VO);
+        edca.createQueue(3, 7, 15, Mac1609_4::AC_VI);
+        edca.createQueue(6, 15, 1023, Mac1609_4::AC_BE);
+        edca.createQueue(9, 15, 1023, Mac1609_4::AC_BK);
+        for (int ac = 0; ac < 4; ++ac) {
+            for (int i = 0; i < queueSize / 2; ++i) {
+                edca.queuePacket(static_cast<Mac1609_4::t_access_category>(ac), new BaseFrame1609_4());
+            }
+        }
+
+        // every frame heard by a node turns the channel busy (stopContent) and idle again (startContent)
+        const simtime_t idleSince = -0.001;
+        long numSent = 0;
+        BENCHMARK("100000 busy/idle transitions")
+        {
+            for (int i = 0; i < 100000; ++i) {
+                edca.startContent(idleSince, false);
+                edca.stopContent(true, true);
+                for (int ac = 3; ac >= 0; --ac) {
+                    if (!edca.myQueues[ac].txOP) continue;
+                    // the highest priority queue with a TXOP wins: send its frame and refill the queue
+                    auto category = static_cast<Mac1609_4::t_access_category>(ac);
+                    BaseFrame1609_4* frame = edca.initiateTransmit(idleSince);
+                    edca.postTransmit(category, frame, false);
+                    edca.queuePacket(category, new BaseFrame1609_4());
+                    ++numSent;
+                    break;
+                }
+                edca.revokeTxOPs();
+            }
+        }
+        REQUIRE(numSent > 0);
+    }
+}
+
+SCENARIO("Mac1609_4 channel busy observers", "[mac]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr));
+
+    GIVEN("A MAC with two observers")
+    {
+        auto mac = std::unique_ptr<ObservableMac>(new ObservableMac());
+        CountingObserver first;
+        auto second = std::unique_ptr<CountingObserver>(new CountingObserver());
+        mac->addChannelBusyObserver(&first);
+        mac->addChannelBusyObserver(second.get());
+
+        WHEN("the channel turns busy and idle")
+        {
+            mac->notifyChannelBusy(true);
+            mac->notifyChannelBusy(false);
+
+            THEN("both observers are notified")
+            {
+                REQUIRE(first.numBusy == 1);
+                REQUIRE(first.numIdle == 1);
+                REQUIRE(second->numBusy == 1);
+                REQUIRE(second->numIdle == 1);
+            }
+        }
+
+        WHEN("an observer is deleted")
+        {
+            second.reset();
+            mac->notifyChannelBusy(true);
+
+            THEN("only the remaining observer is notified")
+            {
+                REQUIRE(first.numBusy == 1);
+            }
+        }
+
+        WHEN("the MAC is deleted")
+        {
+            mac.reset();
+
+            THEN("the observers can still be deleted")
+            {
+                second.reset();
+                REQUIRE(first.numBusy == 0);
+            }
+        }
+    }
+}
+
+SCENARIO("Mac1609_4 channel busy notification performance", "[.][benchmark][mac]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr));
+
+    GIVEN("A MAC notifying a single receiver of 100000 busy/idle transitions")
+    {
+        ObservableMac mac;
+        long numBusy = 0;
+
+        WHEN("the receiver subscribed to sigChannelBusy via SignalManager")
+        {
+            SignalManager signalManager;
+            signalManager.subscribeCallback(&mac, Mac1609_4::sigChannelBusy, [&numBusy](SignalPayload<bool> payload) { numBusy += payload.p ? 1 : 0; });
+            BENCHMARK("signal listener")
+            {
+                for (int i = 0; i < 100000; ++i) {
+                    mac.notifyChannelBusy(true);
+                    mac.notifyChannelBusy(false);
+                }
+            }
+            REQUIRE(numBusy > 0);
+        }
+
+        WHEN("the receiver is a channel busy observer")
+        {
+            CountingObserver observer;
+            mac.addChannelBusyObserver(&observer);
+            BENCHMARK("channel busy observer")
+            {
+                for (int i = 0; i < 100000; ++i) {
+                    mac.notifyChannelBusy(true);
+                    mac.notifyChannelBusy(false);
+                }
+            }
+            REQUIRE(observer.numBusy > 0);
+        }
+    }
+}
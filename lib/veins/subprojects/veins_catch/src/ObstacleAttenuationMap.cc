@@ -0,0 +1,106 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <cstdio>
+#include <fstream>
+
+#include "catch2/catch.hpp"
+
+#include "veins/modules/obstacle/ObstacleAttenuationMap.h"
+
+using veins::Coord;
+using veins::ObstacleAttenuationMap;
+
+SCENARIO("ObstacleAttenuationMap", "[obstacleAttenuationMap]")
+{
+    GIVEN("A 100m x 100m playground with a building in its center, surrounded by a ring road")
+    {
+        // lanes along x = 5, x = 95, y = 5, and y = 95
+        std::vector<std::vector<Coord>> lanes = {{{5, 5}, {95, 5}}, {{95, 5}, {95, 95}}, {{95, 95}, {5, 95}}, {{5, 95}, {5, 5}}};
+        auto roadPositions = ObstacleAttenuationMap::samplePolylines(lanes, 5);
+
+        // 6 dB for links crossing x = 50, no attenuation otherwise
+        auto attenuation = [](const Coord& a, const Coord& b) { return ((a.x < 50) != (b.x < 50)) ? 0.25 : 1.0; };
+
+        const std::string fileName = "obstacleAttenuationMap.test.bin";
+        ObstacleAttenuationMap::create(fileName, 42, roadPositions, 100, 100, 10, 1000, attenuation);
+
+        THEN("lanes are sampled at the requested spacing")
+        {
+            REQUIRE(roadPositions.size() == 4 * (18 + 1));
+        }
+
+        WHEN("loading the table with a different fingerprint")
+        {
+            ObstacleAttenuationMap map;
+
+            THEN("the table is rejected")
+            {
+                REQUIRE_FALSE(map.load(fileName, 43));
+                REQUIRE_FALSE(map.isLoaded());
+            }
+        }
+
+        WHEN("loading the table with the same fingerprint")
+        {
+            ObstacleAttenuationMap map;
+            REQUIRE(map.load(fileName, 42));
+
+            THEN("all cells along the road have an entry")
+            {
+                REQUIRE(map.getNumEntries() == 100 - 8 * 8);
+            }
+
+            THEN("links are attenuated according to the precomputed values")
+            {
+                double factor = -1;
+                REQUIRE(map.lookup({5, 5}, {95, 95}, factor));
+                REQUIRE(factor == Approx(0.25).epsilon(0.03));
+                REQUIRE(map.lookup({95, 95}, {5, 5}, factor));
+                REQUIRE(factor == Approx(0.25).epsilon(0.03));
+                REQUIRE(map.lookup({5, 5}, {5, 95}, factor));
+                REQUIRE(factor == 1);
+            }
+
+            THEN("positions off the road, outside the playground, or in the same cell are not covered")
+            {
+                double factor = -1;
+                REQUIRE_FALSE(map.lookup({45, 45}, {5, 5}, factor));
+                REQUIRE_FALSE(map.lookup({-5, 5}, {5, 5}, factor));
+                REQUIRE_FALSE(map.lookup({5, 5}, {105, 5}, factor));
+                REQUIRE_FALSE(map.lookup({1, 1}, {9, 9}, factor));
+                REQUIRE(factor == -1);
+            }
+        }
+
+        WHEN("the road covers more cells than allowed")
+        {
+            THEN("the table is not created")
+            {
+                REQUIRE_THROWS(ObstacleAttenuationMap::create(fileName + ".large", 42, roadPositions, 100, 100, 10, 35, attenuation));
+                REQUIRE_FALSE(std::ifstream(fileName + ".large"));
+            }
+        }
+
+        std::remove(fileName.c_str());
+    }
+}
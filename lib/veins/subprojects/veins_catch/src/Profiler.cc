@@ -0,0 +1,172 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+// enable the profiling macros in this file (the profiler itself is always compiled)
+#define VEINS_PROFILING
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch.hpp"
+
+#include "veins/modules/utility/Profiler.h"
+#include "testutils/Simulation.h"
+
+using veins::Profiler::Counters;
+using veins::Profiler::getProfile;
+
+namespace {
+
+const auto innerSleep = std::chrono::milliseconds(2);
+const auto outerSleep = std::chrono::milliseconds(3);
+
+void inner()
+{
+    VEINS_PROFILE_SCOPE("ProfilerTest::inner");
+    std::this_thread::sleep_for(innerSleep);
+}
+
+void outer()
+{
+    VEINS_PROFILE_SCOPE("ProfilerTest::outer");
+    std::this_thread::sleep_for(outerSleep);
+    inner();
+    inner();
+}
+
+Counters difference(const Counters& after, const Counters& before)
+{
+    Counters result;
+    result.calls = after.calls - before.calls;
+    result.inclusive = after.inclusive - before.inclusive;
+    result.self = after.self - before.self;
+    return result;
+}
+
+} // namespace
+
+SCENARIO("Profiler counters", "[profiler]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr));
+
+    GIVEN("A profiled section calling another one twice")
+    {
+        auto before = getProfile();
+
+        WHEN("the outer section runs three times")
+        {
+            for (int i = 0; i < 3; ++i) {
+                outer();
+            }
+            auto after = getProfile();
+            const Counters outerCounters = difference(after["ProfilerTest::outer"], before["ProfilerTest::outer"]);
+            const Counters innerCounters = difference(after["ProfilerTest::inner"], before["ProfilerTest::inner"]);
+
+            THEN("calls are counted per section")
+            {
+                REQUIRE(outerCounters.calls == 3);
+                REQUIRE(innerCounters.calls == 6);
+            }
+            THEN("the inclusive time of the outer section contains the inner section")
+            {
+                REQUIRE(innerCounters.inclusive >= 6 * innerSleep);
+                REQUIRE(outerCounters.inclusive >= 3 * outerSleep + 6 * innerSleep);
+            }
+            THEN("the self time of the outer section excludes the inner section")
+            {
+                REQUIRE(innerCounters.self == innerCounters.inclusive);
+                REQUIRE(outerCounters.self >= 3 * outerSleep);
+                REQUIRE(outerCounters.self + innerCounters.inclusive == outerCounters.inclusive);
+            }
+        }
+    }
+
+    GIVEN("A profiled section with kinds")
+    {
+        auto before = getProfile();
+
+        WHEN("it runs with two different kinds")
+        {
+            for (int kind = 0; kind < 4; ++kind) {
+                VEINS_PROFILE_SCOPE_KIND("ProfilerTest::kind", kind % 2);
+            }
+            auto after = getProfile();
+
+            THEN("each kind is counted separately")
+            {
+                REQUIRE(difference(after["ProfilerTest::kind[kind=0]"], before["ProfilerTest::kind[kind=0]"]).calls == 2);
+                REQUIRE(difference(after["ProfilerTest::kind[kind=1]"], before["ProfilerTest::kind[kind=1]"]).calls == 2);
+            }
+        }
+    }
+
+    GIVEN("A profiled section running on several threads")
+    {
+        auto before = getProfile();
+
+        WHEN("each thread runs it and exits")
+        {
+            std::vector<std::thread> threads;
+            for (int i = 0; i < 4; ++i) {
+                threads.emplace_back(outer);
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            auto after = getProfile();
+
+            THEN("the calls of all threads are summed up")
+            {
+                REQUIRE(difference(after["ProfilerTest::outer"], before["ProfilerTest::outer"]).calls == 4);
+                REQUIRE(difference(after["ProfilerTest::inner"], before["ProfilerTest::inner"]).calls == 8);
+            }
+        }
+    }
+}
+
+SCENARIO("Profiler overhead", "[.][benchmark][profiler]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr));
+
+    GIVEN("A loop with and without an empty profiled scope")
+    {
+        const int n = 1000000;
+        volatile int sink = 0;
+
+        BENCHMARK("1000000 iterations of a bare loop")
+        {
+            for (int i = 0; i < n; ++i) {
+                sink = i;
+            }
+        }
+        BENCHMARK("1000000 iterations of an empty profiled scope")
+        {
+            for (int i = 0; i < n; ++i) {
+                VEINS_PROFILE_SCOPE("ProfilerTest::empty");
+                sink = i;
+            }
+        }
+        REQUIRE(getProfile()["ProfilerTest::empty"].calls >= n);
+    }
+}
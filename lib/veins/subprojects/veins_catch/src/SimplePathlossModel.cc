@@ -94,6 +94,21 @@ SCENARIO("SimplePathlossModel with alpha = 2", "[analogueModel]")
                 REQUIRE(s.at(1) == Approx(1.634e-9).epsilon(0.001));
             }
         }
+
+        WHEN("the receiver is at (2, 0), moving away at 10 m/s")
+        {
+            s.setReceiverPoa({AntennaPosition(dummyId, Coord(2, 0, 2), Coord(10, 0, 0), simTime()), {}, nullptr});
+            THEN("filtering for a reception 1 s later gives exactly the same result as a receiver at (12, 0)")
+            {
+                Signal expected(s);
+                expected.setReceiverPoa({createDummyAntennaPosition(Coord(12, 0, 2)), {}, nullptr});
+                spm.filterSignal(&expected);
+                spm.filterSignalAt(&s, simTime() + 1);
+                for (size_t i = 0; i < s.getNumValues(); i++) {
+                    REQUIRE(s.at(i) == expected.at(i));
+                }
+            }
+        }
     }
 }
 
@@ -0,0 +1,344 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include <memory>
+#include <vector>
+
+#include "catch2/catch.hpp"
+
+#include "veins/modules/utility/TimerManager.h"
+#include "testutils/Simulation.h"
+
+using veins::TimerManager;
+using veins::TimerSpecification;
+
+namespace {
+
+class TimerModule : public cSimpleModule {
+public:
+    TimerModule()
+        : timers(this)
+    {
+    }
+
+    /**
+     * Take a message removed from the FES and pass it to the TimerManager, like the kernel does when delivering an event.
+     */
+    bool deliver(cMessage* msg)
+    {
+        take(msg);
+        return timers.handleMessage(msg);
+    }
+
+    TimerManager timers;
+};
+
+/**
+ * Execute all events up to the given time, delivering each one in the context of the module it belongs to.
+ */
+void runUntil(simtime_t end, const std::vector<TimerModule*>& modules)
+{
+    cFutureEventSet* fes = getSimulation()->getFES();
+    while (!fes->isEmpty() && fes->peekFirst()->getArrivalTime() <= end) {
+        auto* msg = check_and_cast<cMessage*>(fes->removeFirst());
+        getSimulation()->setSimTime(msg->getArrivalTime());
+        bool delivered = false;
+        for (auto* module : modules) {
+            cContextSwitcher switcher(module);
+            if (module->deliver(msg)) {
+                delivered = true;
+                break;
+            }
+        }
+        REQUIRE(delivered);
+    }
+    getSimulation()->setSimTime(end);
+}
+
+} // namespace
+
+SCENARIO("TimerManager handles", "[timers]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr));
+    TimerModule module;
+    cContextSwitcher switcher(&module);
+
+    GIVEN("A cancelled timer whose slot was reused by a new timer")
+    {
+        int firedOld = 0;
+        int firedNew = 0;
+        const auto oldHandle = module.timers.create(TimerSpecification([&firedOld]() { ++firedOld; }).interval(1));
+        module.timers.cancel(oldHandle);
+        const auto newHandle = module.timers.create(TimerSpecification([&firedNew]() { ++firedNew; }).interval(1));
+        REQUIRE(oldHandle != newHandle);
+
+        WHEN("the old handle is rescheduled")
+        {
+            const bool rescheduled = module.timers.reschedule(oldHandle, 5, 5);
+            THEN("nothing happens and the new timer keeps its schedule")
+            {
+                REQUIRE_FALSE(rescheduled);
+                runUntil(3, {&module});
+                REQUIRE(firedOld == 0);
+                REQUIRE(firedNew == 3);
+            }
+        }
+        WHEN("the old handle is cancelled")
+        {
+            module.timers.cancel(oldHandle);
+            THEN("the new timer keeps running")
+            {
+                runUntil(3, {&module});
+                REQUIRE(firedOld == 0);
+                REQUIRE(firedNew == 3);
+            }
+        }
+    }
+}
+
+SCENARIO("TimerManager callbacks modifying timers", "[timers]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr));
+    TimerModule module;
+    cContextSwitcher switcher(&module);
+
+    GIVEN("A timer cancelling itself in its second callback")
+    {
+        int fired = 0;
+        TimerManager::TimerHandle handle = 0;
+        handle = module.timers.create(TimerSpecification([&]() {
+            if (++fired == 2) module.timers.cancel(handle);
+        }).interval(1));
+
+        WHEN("the simulation runs")
+        {
+            runUntil(10, {&module});
+            THEN("it does not fire again and leaves no event behind")
+            {
+                REQUIRE(fired == 2);
+                REQUIRE(getSimulation()->getFES()->isEmpty());
+            }
+        }
+        WHEN("a new timer is created after it was cancelled")
+        {
+            runUntil(10, {&module});
+            int firedNew = 0;
+            module.timers.create(TimerSpecification([&firedNew]() { ++firedNew; }).interval(1));
+            THEN("the new timer runs normally")
+            {
+                runUntil(13, {&module});
+                REQUIRE(fired == 2);
+                REQUIRE(firedNew == 3);
+            }
+        }
+    }
+
+    GIVEN("A oneshot timer creating more timers than there are slots in its callback")
+    {
+        const int numCreated = 100;
+        std::vector<int> fired(numCreated, 0);
+        module.timers.create(TimerSpecification([&]() {
+            for (int i = 0; i < numCreated; ++i) {
+                module.timers.create(TimerSpecification([&fired, i]() { ++fired[i]; }).interval(1));
+            }
+        }).oneshotIn(1));
+
+        WHEN("the simulation runs")
+        {
+            runUntil(4, {&module});
+            THEN("all created timers fire from the next period on")
+            {
+                for (int i = 0; i < numCreated; ++i) {
+                    REQUIRE(fired[i] == 3);
+                }
+                REQUIRE(getSimulation()->getFES()->getLength() == numCreated);
+            }
+        }
+    }
+}
+
+SCENARIO("TimerManager coalesced timers of several modules", "[timers]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr));
+    auto owner = std::unique_ptr<TimerModule>(new TimerModule());
+    TimerModule other;
+
+    GIVEN("Two modules whose timers share a group created by the first one")
+    {
+        int firedOwner = 0;
+        int firedOther = 0;
+        int cancelOwnerAt = 0;
+        TimerManager::TimerHandle ownerHandle = 0;
+        TimerManager::TimerHandle otherHandle = 0;
+        {
+            cContextSwitcher switcher(owner.get());
+            ownerHandle = owner->timers.create(TimerSpecification([&]() {
+                if (++firedOwner == cancelOwnerAt) owner->timers.cancel(ownerHandle);
+            }).interval(1).coalesce());
+        }
+        {
+            cContextSwitcher switcher(&other);
+            otherHandle = other.timers.create(TimerSpecification([&firedOther]() { ++firedOther; }).interval(1).coalesce());
+        }
+        runUntil(2, {owner.get(), &other});
+        REQUIRE(firedOwner == 2);
+        REQUIRE(firedOther == 2);
+        REQUIRE(getSimulation()->getFES()->getLength() == 1);
+
+        WHEN("the owning module cancels its timer")
+        {
+            {
+                cContextSwitcher switcher(owner.get());
+                owner->timers.cancel(ownerHandle);
+            }
+            THEN("the message is handed over and the other timer still fires")
+            {
+                REQUIRE(getSimulation()->getFES()->getLength() == 1);
+                runUntil(4, {owner.get(), &other});
+                REQUIRE(firedOwner == 2);
+                REQUIRE(firedOther == 4);
+            }
+        }
+        WHEN("the owning module is deleted")
+        {
+            owner.reset();
+            THEN("the message is handed over and the other timer still fires")
+            {
+                REQUIRE(getSimulation()->getFES()->getLength() == 1);
+                runUntil(4, {&other});
+                REQUIRE(firedOther == 4);
+            }
+        }
+        WHEN("the owning module cancels its timer from inside the shared event")
+        {
+            cancelOwnerAt = 3;
+            THEN("the message is handed over and the other timer still fires")
+            {
+                runUntil(5, {owner.get(), &other});
+                REQUIRE(firedOwner == 3);
+                REQUIRE(firedOther == 5);
+                REQUIRE(getSimulation()->getFES()->getLength() == 1);
+            }
+        }
+        WHEN("both timers are cancelled")
+        {
+            {
+                cContextSwitcher switcher(&other);
+                other.timers.cancel(otherHandle);
+            }
+            REQUIRE(getSimulation()->getFES()->getLength() == 1);
+            {
+                cContextSwitcher switcher(owner.get());
+                owner->timers.cancel(ownerHandle);
+            }
+            THEN("the group is deleted along with its message")
+            {
+                REQUIRE(getSimulation()->getFES()->isEmpty());
+                runUntil(4, {owner.get(), &other});
+                REQUIRE(firedOwner == 2);
+                REQUIRE(firedOther == 2);
+            }
+        }
+    }
+}
+
+SCENARIO("TimerManager rescheduling timers", "[timers]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr));
+    TimerModule module;
+    TimerModule other;
+    cContextSwitcher switcher(&module);
+
+    GIVEN("A timer rescheduling itself in its second callback")
+    {
+        std::vector<simtime_t> fired;
+        TimerManager::TimerHandle handle = 0;
+        handle = module.timers.create(TimerSpecification([&]() {
+            fired.push_back(simTime());
+            if (fired.size() == 2) REQUIRE(module.timers.reschedule(handle, 2, simTime() + 3));
+        }).interval(1));
+
+        WHEN("the simulation runs")
+        {
+            runUntil(9, {&module});
+            THEN("it continues at the new time and interval")
+            {
+                REQUIRE(fired == std::vector<simtime_t>({1, 2, 5, 7, 9}));
+                REQUIRE(getSimulation()->getFES()->getLength() == 1);
+            }
+        }
+    }
+
+    GIVEN("A timer rescheduled by the callback of another timer")
+    {
+        std::vector<simtime_t> fired;
+        const auto handle = module.timers.create(TimerSpecification([&fired]() { fired.push_back(simTime()); }).interval(1));
+        module.timers.create(TimerSpecification([&]() { REQUIRE(module.timers.reschedule(handle, 3, 4)); }).oneshotIn(2.5));
+
+        WHEN("the simulation runs")
+        {
+            runUntil(9, {&module});
+            THEN("it continues at the new time and interval")
+            {
+                REQUIRE(fired == std::vector<simtime_t>({1, 2, 4, 7}));
+                REQUIRE(getSimulation()->getFES()->getLength() == 1);
+            }
+        }
+    }
+
+    GIVEN("Two modules whose coalesced timers share a group created by the first one")
+    {
+        std::vector<simtime_t> firedModule;
+        std::vector<simtime_t> firedOther;
+        const auto handle = module.timers.create(TimerSpecification([&firedModule]() { firedModule.push_back(simTime()); }).interval(1).coalesce());
+        {
+            cContextSwitcher switcher(&other);
+            other.timers.create(TimerSpecification([&firedOther]() { firedOther.push_back(simTime()); }).interval(1).coalesce());
+        }
+        runUntil(2, {&module, &other});
+
+        WHEN("the timer of the first module is moved to another group")
+        {
+            REQUIRE(module.timers.reschedule(handle, 1, 2.5));
+            THEN("both groups fire on their own")
+            {
+                REQUIRE(getSimulation()->getFES()->getLength() == 2);
+                runUntil(4, {&module, &other});
+                REQUIRE(firedModule == std::vector<simtime_t>({1, 2, 2.5, 3.5}));
+                REQUIRE(firedOther == std::vector<simtime_t>({1, 2, 3, 4}));
+            }
+        }
+        WHEN("the timer is moved back into the group of the other module")
+        {
+            REQUIRE(module.timers.reschedule(handle, 1, 2.5));
+            REQUIRE(module.timers.reschedule(handle, 1, 3));
+            THEN("the timers share their events again")
+            {
+                REQUIRE(getSimulation()->getFES()->getLength() == 1);
+                runUntil(4, {&module, &other});
+                REQUIRE(firedModule == std::vector<simtime_t>({1, 2, 3, 4}));
+                REQUIRE(firedOther == std::vector<simtime_t>({1, 2, 3, 4}));
+            }
+        }
+    }
+}
@@ -0,0 +1,101 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <algorithm>
+#include <random>
+
+#include "catch2/catch.hpp"
+
+#include "veins/modules/obstacle/VehicleObstacleGrid.h"
+
+using veins::Coord;
+using veins::VehicleObstacleGrid;
+
+namespace {
+
+/**
+ * check if the box, grown by margin, overlaps the line from sender to receiver (by sampling the line)
+ */
+bool isNearLine(const VehicleObstacleGrid::Box& box, const Coord& sender, const Coord& receiver, double margin)
+{
+    const int steps = 10000;
+    for (int i = 0; i <= steps; ++i) {
+        Coord p = sender + (receiver - sender) * (double(i) / steps);
+        if (p.x >= box.p1.x - margin && p.x <= box.p2.x + margin && p.y >= box.p1.y - margin && p.y <= box.p2.y + margin) return true;
+    }
+    return false;
+}
+
+} // anonymous namespace
+
+SCENARIO("VehicleObstacleGrid", "[vehicleObstacles]")
+{
+    GIVEN("200 vehicles on a 1000m x 1000m playground (some of them outside) with 50m cells")
+    {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<double> pos(-50, 1050);
+        std::vector<VehicleObstacleGrid::Box> boxes;
+        for (int i = 0; i < 200; ++i) {
+            Coord p(pos(rng), pos(rng));
+            boxes.push_back({p - Coord(3, 3), p + Coord(3, 3)});
+        }
+        VehicleObstacleGrid grid(1000, 1000, 50);
+        grid.rebuild(boxes);
+
+        THEN("random links find every vehicle close to them, each only once")
+        {
+            std::vector<size_t> candidates;
+            for (int i = 0; i < 200; ++i) {
+                Coord sender(pos(rng), pos(rng));
+                Coord receiver(pos(rng), pos(rng));
+                if (i % 10 == 0) receiver.x = sender.x;
+                const double margin = (i % 2) ? 0 : 4;
+                grid.findCandidates(sender, receiver, margin, candidates);
+                REQUIRE(std::is_sorted(candidates.begin(), candidates.end()));
+                REQUIRE(std::adjacent_find(candidates.begin(), candidates.end()) == candidates.end());
+                for (size_t j = 0; j < boxes.size(); ++j) {
+                    if (!isNearLine(boxes[j], sender, receiver, margin)) continue;
+                    REQUIRE(std::binary_search(candidates.begin(), candidates.end(), j));
+                }
+            }
+        }
+
+        THEN("a short link only finds vehicles close to it")
+        {
+            std::vector<size_t> candidates;
+            grid.findCandidates({500, 500}, {520, 500}, 0, candidates);
+            REQUIRE(candidates.size() < boxes.size() / 10);
+        }
+
+        WHEN("rebuilding the grid without vehicles")
+        {
+            grid.rebuild({});
+
+            THEN("nothing is found")
+            {
+                std::vector<size_t> candidates = {1, 2, 3};
+                grid.findCandidates({0, 0}, {1000, 1000}, 10, candidates);
+                REQUIRE(candidates.empty());
+            }
+        }
+    }
+}
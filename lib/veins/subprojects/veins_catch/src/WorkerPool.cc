@@ -0,0 +1,84 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "catch2/catch.hpp"
+
+#include "veins/base/utils/WorkerPool.h"
+
+using veins::WorkerPool;
+
+SCENARIO("WorkerPool", "[workerPool]")
+{
+    GIVEN("A pool of 4 worker threads")
+    {
+        WorkerPool pool(4);
+
+        WHEN("running many batches of tasks")
+        {
+            std::vector<int> results(1000, 0);
+            for (int batch = 0; batch < 100; ++batch) {
+                pool.parallelFor(results.size(), [&results](size_t i) { results[i] += static_cast<int>(i); });
+            }
+
+            THEN("every task ran exactly once per batch")
+            {
+                for (size_t i = 0; i < results.size(); ++i) {
+                    REQUIRE(results[i] == 100 * static_cast<int>(i));
+                }
+            }
+        }
+
+        WHEN("a task throws")
+        {
+            std::vector<int> ran(100, 0);
+            auto run = [&]() {
+                pool.parallelFor(ran.size(), [&ran](size_t i) {
+                    ran[i] = 1;
+                    if (i == 42) throw std::runtime_error("task failed");
+                });
+            };
+
+            THEN("the exception is rethrown after all other tasks ran")
+            {
+                REQUIRE_THROWS_AS(run(), std::runtime_error);
+                REQUIRE(std::count(ran.begin(), ran.end(), 1) == 100);
+            }
+
+            THEN("the pool can still be used")
+            {
+                REQUIRE_THROWS(run());
+                int sum = 0;
+                std::mutex mutex;
+                pool.parallelFor(10, [&](size_t i) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    sum += static_cast<int>(i);
+                });
+                REQUIRE(sum == 45);
+            }
+        }
+    }
+}
@@ -0,0 +1,126 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "catch2/catch.hpp"
+
+#include "veins/modules/mobility/traci/TraCIBuffer.h"
+#include "veins/modules/mobility/traci/TraCIConstants.h"
+
+using veins::TraCIBuffer;
+using veins::TraCIStringView;
+namespace TraCIConstants = veins::TraCIConstants;
+
+SCENARIO("TraCIBuffer stores values in network byte order", "[traciBuffer]")
+{
+    GIVEN("A buffer with some values written to it")
+    {
+        TraCIBuffer buf;
+        buf << static_cast<uint8_t>(0x01) << static_cast<int32_t>(0x02030405) << 1.5 << std::string("veh0") << std::string("");
+
+        THEN("integers are stored big-endian")
+        {
+            const std::string expected("\x01\x02\x03\x04\x05", 5);
+            REQUIRE(buf.str().substr(0, 5) == expected);
+        }
+
+        THEN("all values can be read back")
+        {
+            REQUIRE(buf.read<uint8_t>() == 0x01);
+            REQUIRE(buf.read<int32_t>() == 0x02030405);
+            REQUIRE(buf.read<double>() == 1.5);
+            std::string id;
+            buf >> id;
+            REQUIRE(id == "veh0");
+            REQUIRE(buf.read<std::string>() == "");
+            REQUIRE(buf.eof());
+        }
+
+        THEN("strings can be read without copying them")
+        {
+            buf.read<uint8_t>();
+            buf.read<int32_t>();
+            buf.read<double>();
+            TraCIStringView id = buf.readStringView();
+            REQUIRE(id == std::string("veh0"));
+            REQUIRE(id.data() == buf.data() + 1 + 4 + 8 + 4);
+            REQUIRE(buf.readStringView().empty());
+        }
+
+        THEN("reading past the end fails")
+        {
+            TraCIBuffer copy(buf.str().substr(0, 3));
+            copy.read<uint8_t>();
+            REQUIRE_THROWS(copy.read<int32_t>());
+        }
+    }
+}
+
+SCENARIO("TraCIBuffer performance", "[.][benchmark][traciBuffer]")
+{
+    GIVEN("A step response with a subscription result for 20000 vehicles")
+    {
+        const int numVehicles = 20000;
+        TraCIBuffer response;
+        for (int i = 0; i < numVehicles; ++i) {
+            response << static_cast<uint8_t>(0) << static_cast<int32_t>(0) << static_cast<uint8_t>(TraCIConstants::RESPONSE_SUBSCRIBE_VEHICLE_VARIABLE);
+            response << std::string("flow0.") + std::to_string(i) << static_cast<uint8_t>(3);
+            response << static_cast<uint8_t>(TraCIConstants::VAR_POSITION) << static_cast<uint8_t>(TraCIConstants::RTYPE_OK) << static_cast<uint8_t>(TraCIConstants::POSITION_2D) << 100.0 * i << 200.0 * i;
+            response << static_cast<uint8_t>(TraCIConstants::VAR_ROAD_ID) << static_cast<uint8_t>(TraCIConstants::RTYPE_OK) << static_cast<uint8_t>(TraCIConstants::TYPE_STRING) << std::string("-1234567#1");
+            response << static_cast<uint8_t>(TraCIConstants::VAR_SPEED) << static_cast<uint8_t>(TraCIConstants::RTYPE_OK) << static_cast<uint8_t>(TraCIConstants::TYPE_DOUBLE) << 13.89;
+        }
+        const std::string message = response.str();
+
+        double sum = 0;
+        BENCHMARK("parsing " + std::to_string(message.size()) + " bytes, 100 times")
+        {
+            std::string id;
+            std::string edge;
+            for (int run = 0; run < 100; ++run) {
+                TraCIBuffer buf(message);
+                for (int i = 0; i < numVehicles; ++i) {
+                    buf.read<uint8_t>();
+                    buf.read<int32_t>();
+                    buf.read<uint8_t>();
+                    buf >> id;
+                    uint8_t numVars = buf.read<uint8_t>();
+                    for (uint8_t j = 0; j < numVars; ++j) {
+                        uint8_t varId = buf.read<uint8_t>();
+                        buf.read<uint8_t>();
+                        buf.read<uint8_t>();
+                        if (varId == TraCIConstants::VAR_POSITION) {
+                            sum += buf.read<double>();
+                            sum += buf.read<double>();
+                        }
+                        else if (varId == TraCIConstants::VAR_ROAD_ID) {
+                            buf >> edge;
+                        }
+                        else {
+                            sum += buf.read<double>();
+                        }
+                    }
+                }
+                REQUIRE(buf.eof());
+            }
+        }
+        REQUIRE(sum > 0);
+    }
+}
@@ -0,0 +1,225 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch.hpp"
+
+#include "veins/modules/mobility/traci/TraCIConnection.h"
+#include "veins/modules/mobility/traci/TraCIConstants.h"
+#include "testutils/Simulation.h"
+
+using veins::TraCIBuffer;
+using veins::TraCIConnection;
+namespace TraCIConstants = veins::TraCIConstants;
+
+namespace {
+
+bool readAll(int fd, char* p, size_t length)
+{
+    while (length > 0) {
+        ssize_t n = ::read(fd, p, length);
+        if (n <= 0) return false;
+        p += n;
+        length -= n;
+    }
+    return true;
+}
+
+bool writeAll(int fd, const char* p, size_t length)
+{
+    while (length > 0) {
+        ssize_t n = ::write(fd, p, length);
+        if (n <= 0) return false;
+        p += n;
+        length -= n;
+    }
+    return true;
+}
+
+/**
+ * Minimal TraCI server: answers each (short) command with an OK status response.
+ * If the uint32 parameter of the command is not zero, the status response is followed by a response command with as many bytes of payload.
+ */
+void serveOneClient(int listenFd)
+{
+    int fd = ::accept(listenFd, nullptr, nullptr);
+    ::close(listenFd);
+    if (fd < 0) return;
+    std::string request;
+    std::string body;
+    bool closed = false;
+    while (!closed) {
+        char header[4];
+        if (!readAll(fd, header, sizeof(header))) break;
+        uint32_t msgLength;
+        TraCIBuffer(std::string(header, sizeof(header))) >> msgLength;
+        request.resize(msgLength - sizeof(msgLength));
+        if (!readAll(fd, &request[0], request.size())) break;
+
+        TraCIBuffer in(request);
+        body.clear();
+        while (!in.eof()) {
+            in.read<uint8_t>(); // command length
+            uint8_t commandId = in.read<uint8_t>();
+            uint32_t payloadSize = in.read<uint32_t>();
+            TraCIBuffer out;
+            out << static_cast<uint8_t>(7) << commandId << static_cast<uint8_t>(TraCIConstants::RTYPE_OK) << std::string();
+            if (payloadSize > 0) out << static_cast<uint8_t>(0) << static_cast<uint32_t>(6 + payloadSize) << static_cast<uint8_t>(commandId + 0x10);
+            body += out.str();
+            body.append(payloadSize, 'x');
+            closed |= (commandId == TraCIConstants::CMD_CLOSE);
+        }
+        std::string response = (TraCIBuffer() << static_cast<uint32_t>(sizeof(uint32_t) + body.size())).str() + body;
+        if (!writeAll(fd, response.data(), response.size())) break;
+    }
+    ::close(fd);
+}
+
+/**
+ * start a server thread listening on the TCP loopback interface, return the host to connect to
+ */
+std::string startTcpServer(int& port, std::thread& server)
+{
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    REQUIRE(::bind(fd, reinterpret_cast<sockaddr*>(&address), length) == 0);
+    REQUIRE(::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) == 0);
+    REQUIRE(::listen(fd, 1) == 0);
+    port = ntohs(address.sin_port);
+    server = std::thread(serveOneClient, fd);
+    return "127.0.0.1";
+}
+
+/**
+ * start a server thread listening on a Unix domain socket, return the host to connect to
+ */
+std::string startUnixServer(const std::string& path, std::thread& server)
+{
+    std::remove(path.c_str());
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    std::snprintf(address.sun_path, sizeof(address.sun_path), "%s", path.c_str());
+    REQUIRE(::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+    REQUIRE(::listen(fd, 1) == 0);
+    server = std::thread(serveOneClient, fd);
+    return "unix:" + path;
+}
+
+} // anonymous namespace
+
+SCENARIO("TraCIConnection splits the responses to a batch of commands", "[traciConnection]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr));
+
+    GIVEN("A connection to a TraCI server")
+    {
+        std::thread server;
+        int port = 0;
+        std::string host = startTcpServer(port, server);
+        std::unique_ptr<TraCIConnection> connection(TraCIConnection::connect(nullptr, host.c_str(), port));
+
+        WHEN("sending commands with and without (short and long) additional responses in one message")
+        {
+            std::vector<std::pair<uint8_t, TraCIBuffer>> commands;
+            for (uint32_t payloadSize : {0, 10, 0, 0, 1000, 10}) {
+                commands.emplace_back(TraCIConstants::CMD_GET_VEHICLE_VARIABLE, TraCIBuffer() << payloadSize);
+            }
+            commands.emplace_back(TraCIConstants::CMD_SET_VEHICLE_VARIABLE, TraCIBuffer() << static_cast<uint32_t>(0));
+            std::vector<TraCIBuffer> responses = connection->queryBatch(commands);
+
+            THEN("each command gets its own additional responses")
+            {
+                REQUIRE(responses.size() == 7);
+                REQUIRE(responses[0].eof());
+                REQUIRE(responses[1].read<uint8_t>() == 0);
+                REQUIRE(responses[1].read<uint32_t>() == 16);
+                REQUIRE(responses[1].read<uint8_t>() == TraCIConstants::RESPONSE_GET_VEHICLE_VARIABLE);
+                REQUIRE(responses[2].eof());
+                REQUIRE(responses[3].eof());
+                REQUIRE(responses[4].read<uint8_t>() == 0);
+                REQUIRE(responses[4].read<uint32_t>() == 1006);
+                REQUIRE(responses[5].size() == 7 + 6 + 10);
+                REQUIRE(responses[6].eof());
+            }
+        }
+
+        connection->query(TraCIConstants::CMD_CLOSE, TraCIBuffer() << static_cast<uint32_t>(0));
+        server.join();
+    }
+}
+
+SCENARIO("TraCIConnection round-trip latency", "[.][benchmark][traciConnection]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr));
+    const std::string socketPath = "traciConnection.benchmark.sock";
+
+    for (std::string transport : {"TCP", "Unix domain socket"}) {
+        GIVEN("A connection via " + transport)
+        {
+            std::thread server;
+            int port = 0;
+            std::string host = (transport == "TCP") ? startTcpServer(port, server) : startUnixServer(socketPath, server);
+            std::unique_ptr<TraCIConnection> connection(TraCIConnection::connect(nullptr, host.c_str(), port));
+
+            BENCHMARK(transport + ": 10000 small commands")
+            {
+                for (int i = 0; i < 10000; ++i) {
+                    connection->query(TraCIConstants::CMD_SIMSTEP2, TraCIBuffer() << static_cast<uint32_t>(4));
+                }
+            }
+
+            BENCHMARK(transport + ": 100 batches of 100 small commands")
+            {
+                std::vector<std::pair<uint8_t, TraCIBuffer>> commands(100, std::make_pair(static_cast<uint8_t>(TraCIConstants::CMD_GET_VEHICLE_VARIABLE), TraCIBuffer() << static_cast<uint32_t>(4)));
+                for (int i = 0; i < 100; ++i) {
+                    connection->queryBatch(commands);
+                }
+            }
+
+            size_t received = 0;
+            BENCHMARK(transport + ": 100 commands with 4 MB responses")
+            {
+                for (int i = 0; i < 100; ++i) {
+                    received += connection->query(TraCIConstants::CMD_SIMSTEP2, TraCIBuffer() << static_cast<uint32_t>(4 << 20)).size();
+                }
+            }
+            REQUIRE(received > 0);
+
+            connection->query(TraCIConstants::CMD_CLOSE, TraCIBuffer() << static_cast<uint32_t>(0));
+            server.join();
+        }
+    }
+    std::remove(socketPath.c_str());
+}
@@ -0,0 +1,95 @@
+//
+// Copyright (C) 2021 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <cstdio>
+#include <fstream>
+
+#include "catch2/catch.hpp"
+
+#include "veins/modules/mobility/traci/TraCIPolygonCache.h"
+
+using veins::Coord;
+using veins::TraCICoord;
+using veins::TraCIPolygonCache;
+
+SCENARIO("TraCIPolygonCache", "[traci][polygonCache]")
+{
+    GIVEN("A polygon cache written for a source file")
+    {
+        const std::string sourceFileName = "traciPolygonCache.test.poly.xml";
+        const std::string cacheFileName = "traciPolygonCache.test.bin";
+        std::ofstream(sourceFileName) << "<poly id=\"building#0\"/>";
+        const std::pair<TraCICoord, TraCICoord> networkBoundaries(TraCICoord(-25, -25), TraCICoord(125, 125));
+
+        TraCIPolygonCache::Polygon building;
+        building.id = "building#0";
+        building.typeId = "building";
+        building.hasShape = true;
+        building.shape = {Coord(40, 40), Coord(60, 40), Coord(60, 60), Coord(40, 60)};
+        TraCIPolygonCache::Polygon park;
+        park.id = "park#0";
+        park.typeId = "park";
+
+        TraCIPolygonCache written(cacheFileName, {sourceFileName});
+        REQUIRE_FALSE(written.load());
+        written.store(networkBoundaries, 25, {building, park});
+
+        WHEN("loading it again")
+        {
+            TraCIPolygonCache cache(cacheFileName, {sourceFileName});
+            REQUIRE(cache.load());
+
+            THEN("all polygons are restored")
+            {
+                REQUIRE(cache.getPolygons().size() == 2);
+                REQUIRE(cache.getPolygons()[0].id == building.id);
+                REQUIRE(cache.getPolygons()[0].typeId == building.typeId);
+                REQUIRE(cache.getPolygons()[0].hasShape);
+                REQUIRE(cache.getPolygons()[0].shape == building.shape);
+                REQUIRE(cache.getPolygons()[1].id == park.id);
+                REQUIRE_FALSE(cache.getPolygons()[1].hasShape);
+            }
+
+            THEN("it is only valid for the same network boundaries and margin")
+            {
+                REQUIRE(cache.isValidFor(networkBoundaries, 25));
+                REQUIRE_FALSE(cache.isValidFor(networkBoundaries, 0));
+                REQUIRE_FALSE(cache.isValidFor({TraCICoord(0, 0), TraCICoord(100, 100)}, 25));
+            }
+        }
+
+        WHEN("the source file changes")
+        {
+            std::ofstream(sourceFileName) << "<poly id=\"building#1\"/>";
+            TraCIPolygonCache cache(cacheFileName, {sourceFileName});
+
+            THEN("the cache is stale")
+            {
+                REQUIRE_FALSE(cache.load());
+                REQUIRE_FALSE(cache.isValidFor(networkBoundaries, 25));
+            }
+        }
+
+        std::remove(sourceFileName.c_str());
+        std::remove(cacheFileName.c_str());
+    }
+}
@@ -137,8 +137,9 @@ void TraCITestApp::handlePositionUpdate()
             assertTrue("(TraCICommandInterface::addVehicle) command reports success", r);
         }
         if (t == 30) {
-            std::map<std::string, cModule*>::const_iterator i = mobility->getManager()->getManagedHosts().find("testVehicle0");
-            bool r = (i != mobility->getManager()->getManagedHosts().end());
+            const std::map<std::string, cModule*> hosts = mobility->getManager()->getManagedHosts();
+            std::map<std::string, cModule*>::const_iterator i = hosts.find("testVehicle0");
+            bool r = (i != hosts.end());
             assertTrue("(TraCICommandInterface::addVehicle) vehicle now driving", r);
             const cModule* mod = i->second;
             const TraCIMobility* traci2 = FindModule<TraCIMobility*>::findSubModule(const_cast<cModule*>(mod));
@@ -25,6 +25,7 @@
 #include "veins/modules/mobility/traci/TraCIMobility.h"
 #include "veins/modules/utility/Consts80211p.h"
 #include "veins/modules/mac/ieee80211p/Mac1609_4.h"
+#include "veins/modules/utility/Profiler.h"
 #include "dcc/Beacon_m.h"
 #include "dcc/GymConnection.h"
 
@@ -40,7 +41,7 @@ void DCCApp::initialize(int stage)
 
     if (stage == 0) {
         // set up beaconing timer
-        rescheduleBeacon(currentBeaconInterval(), 0);
+        rescheduleBeacon(currentBeaconInterval());
 
         // set up sampling timer
         timerManager.create(
@@ -54,16 +55,10 @@ void DCCApp::initialize(int stage)
         ASSERT(mobilityModules.size() == 1);
         mobility = mobilityModules.front();
 
-        // register to channel busy/idle change signals
-        auto channelBusyCallback = [this](veins::SignalPayload<bool> payload) {
-            channelBusyHistory.emplace_back(simTime(), payload.p);
-            // prune old entries
-            simtime_t windowEnd = simTime() - std::max(par("rampUpWindow").doubleValue(), par("rampDownWindow").doubleValue());
-            while (channelBusyHistory.front().first < windowEnd) {
-                channelBusyHistory.erase(channelBusyHistory.begin());
-            }
-        };
-        signalManager.subscribeCallback(getParentModule(), Mac1609_4::sigChannelBusy, channelBusyCallback);
+        // observe channel busy/idle changes of our MAC
+        auto macModules = getSubmodulesOfType<Mac1609_4>(getParentModule(), true);
+        ASSERT(macModules.size() == 1);
+        macModules.front()->addChannelBusyObserver(this);
     }
 }
 
@@ -74,6 +69,7 @@ void DCCApp::finish()
 
 void DCCApp::handleSelfMsg(cMessage* msg)
 {
+    VEINS_PROFILE_SCOPE("DCCApp::handleSelfMsg");
     timerManager.handleMessage(msg);
 }
 
@@ -147,18 +143,32 @@ void DCCApp::beacon()
     sendDown(beacon);
 }
 
+void DCCApp::channelBusyChanged(simtime_t time, bool busy)
+{
+    channelBusyHistory.emplace_back(time, busy);
+    // prune old entries
+    simtime_t windowEnd = time - std::max(par("rampUpWindow").doubleValue(), par("rampDownWindow").doubleValue());
+    while (channelBusyHistory.front().first < windowEnd) {
+        channelBusyHistory.erase(channelBusyHistory.begin());
+    }
+}
+
 void DCCApp::handleLowerMsg(cMessage* msg)
 {
+    VEINS_PROFILE_SCOPE("DCCApp::handleLowerMsg");
     auto* beacon = check_and_cast<Beacon*>(msg);
     std::string senderId{beacon->getSenderId()};
+    // a single lookup finds or adds the neighbor
+    auto entry = neighbors.emplace(senderId, Neighbor());
+    Neighbor& neighbor = entry.first->second;
     EV_INFO << "Received beacon from " << senderId << "(" << beacon->getSenderState() << ") at " << getParentModule()->getFullPath() << "; ";
-    if (neighbors.find(senderId) == neighbors.end()) {
+    if (entry.second) {
         EV_INFO << "previously unknown\n";
     }
     else {
-        EV_INFO << "last info from " << (simTime() - neighbors[senderId].timestamp).inUnit(SIMTIME_MS) << "ms ago.\n";
+        EV_INFO << "last info from " << (simTime() - neighbor.timestamp).inUnit(SIMTIME_MS) << "ms ago.\n";
     }
-    neighbors[senderId] = { senderId, beacon->getSenderPos(), beacon->getSenderSpeed(), simTime() };
+    neighbor = { senderId, beacon->getSenderPos(), beacon->getSenderSpeed(), simTime() };
     cancelAndDelete(msg);
 }
 
@@ -177,14 +187,16 @@ simtime_t DCCApp::currentBeaconInterval() const
     }
 }
 
-void DCCApp::rescheduleBeacon(simtime_t beaconInterval, TimerManager::TimerHandle handle)
+void DCCApp::rescheduleBeacon(simtime_t beaconInterval)
 {
-    if (handle != 0) {
-        timerManager.cancel(handle);
+    // keep the existing timer, but start the new interval at a random offset as before
+    const simtime_t nextBeacon = simTime() + uniform(0, beaconInterval);
+    if (beaconHandle != 0 && timerManager.reschedule(beaconHandle, beaconInterval, nextBeacon)) {
+        return;
     }
     beaconHandle = timerManager.create(
         TimerSpecification([this]() { this->beacon(); })
-        .relativeStart(uniform(0, beaconInterval))
+        .absoluteStart(nextBeacon)
         .interval(beaconInterval)
     );
 }
@@ -225,7 +237,7 @@ void DCCApp::switchToState(State newState)
 
     // re-schedule next beacon
     auto beaconInterval = currentBeaconInterval();
-    rescheduleBeacon(beaconInterval, beaconHandle);
+    rescheduleBeacon(beaconInterval);
 }
 
 std::ostream& operator<<(std::ostream& os, DCCApp::State state)
@@ -26,7 +26,7 @@
 
 #include "veins/base/modules/BaseApplLayer.h"
 #include "veins/base/utils/Coord.h"
-#include "veins/modules/utility/SignalManager.h"
+#include "veins/modules/mac/ieee80211p/Mac1609_4.h"
 #include "veins/modules/utility/TimerManager.h"
 
 namespace veins {
@@ -35,7 +35,7 @@ class BaseMobility;
 
 namespace dcc {
 
-class DCCApp : public BaseApplLayer {
+class DCCApp : public BaseApplLayer, public Mac1609_4::ChannelBusyObserver {
 public:
     enum class State {
         relaxed,
@@ -61,12 +61,14 @@ public:
     void beacon();
     void handleLowerMsg(cMessage* msg) override;
 
+    // channel busy/idle transitions of our MAC
+    void channelBusyChanged(simtime_t time, bool busy) override;
+
     double ageOfInformationScore(double timeHorizon) const;
     double channelBusyRatio(simtime_t windowSize) const;
     State getState() const { return state; }
 
 protected:
-    SignalManager signalManager;
     TimerManager timerManager{this};
     BaseMobility* mobility;
     std::unordered_map<std::string, Neighbor> neighbors;
@@ -77,7 +79,7 @@ private:
     State state = State::restrictive;
 
     simtime_t currentBeaconInterval() const;
-    void rescheduleBeacon(simtime_t beaconInterval, TimerManager::TimerHandle handle=0);
+    void rescheduleBeacon(simtime_t beaconInterval);
     void sampleDCC();
     void switchToState(State newState);
 };
@@ -26,6 +26,7 @@
 #include <tuple>
 
 #include "veins/modules/mobility/traci/TraCIScenarioManager.h"
+#include "veins/modules/utility/Profiler.h"
 #include "dcc/DCCApp.h"
 
 Define_Module(GymConnection);
@@ -138,6 +139,7 @@ void GymConnection::finish()
 
 veinsgym::proto::Reply GymConnection::communicate(veinsgym::proto::Request request)
 {
+    VEINS_PROFILE_SCOPE("GymConnection::communicate");
     veinsgym::proto::Reply reply;
     // do we want to use this at all?
     if (par("enable")) {